@@ -0,0 +1,215 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_async_session.h
+ * @brief Asynchronous image processing with futures or completion callbacks
+ *        (header-only, built on top of the public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_ASYNC_SESSION_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_ASYNC_SESSION_H_INCLUDED
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <ocrstudiosdk/ocr_studio_session.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Completion callbacks for asynchronous processing. The callbacks are
+ *        invoked on the worker thread of OCRStudioSDKAsyncSession and should
+ *        return quickly, as the next queued image waits for them.
+ */
+class OCRStudioSDKResultDelegate {
+public:
+  /// Virtual destructor
+  virtual ~OCRStudioSDKResultDelegate() = default;
+
+  /**
+   * @brief Called when an image has been processed
+   * @param result - the session result right after processing the image
+   *        (valid only during the call, use DeepCopy() to retain it)
+   */
+  virtual void ResultCallback(const OCRStudioSDKResult& result) = 0;
+
+  /**
+   * @brief Called when processing of an image has thrown an exception
+   * @param exception - the thrown exception
+   */
+  virtual void ErrorCallback(const OCRStudioSDKException& exception) = 0;
+};
+
+
+
+/**
+ * @brief Session wrapper which processes images on a dedicated worker thread.
+ *        Submitted images are processed one at a time in the order of
+ *        submission, so the wrapper is suitable both for single-image and
+ *        for video sessions. Submission methods may be called from any thread.
+ */
+class OCRStudioSDKAsyncSession {
+public:
+  /**
+   * @brief Main constructor, starts the worker thread
+   * @param session - session to be driven asynchronously, the ownership
+   *        is taken by the wrapper
+   */
+  explicit OCRStudioSDKAsyncSession(OCRStudioSDKSession* session)
+    : session_(session),
+      busy_(false),
+      stopping_(false) {
+    worker_ = std::thread(&OCRStudioSDKAsyncSession::RunWorker, this);
+  }
+
+  /// Destructor, processes all pending images and stops the worker thread
+  ~OCRStudioSDKAsyncSession() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    worker_.join();
+  }
+
+  /**
+   * @brief Queues an image for processing
+   * @param image - the input image, must remain valid until the returned
+   *        future is ready
+   * @return Future holding a deep copy of the session result right after
+   *         processing the image, or the OCRStudioSDKException thrown
+   *         during processing
+   */
+  std::future<std::unique_ptr<OCRStudioSDKResult> > ProcessImageAsync(
+      const OCRStudioSDKImage& image) {
+    typedef std::promise<std::unique_ptr<OCRStudioSDKResult> > ResultPromise;
+    std::shared_ptr<ResultPromise> promise(new ResultPromise());
+    std::future<std::unique_ptr<OCRStudioSDKResult> > future =
+        promise->get_future();
+
+    OCRStudioSDKSession* session = session_.get();
+    const OCRStudioSDKImage* image_ptr = &image;
+    Enqueue([session, image_ptr, promise]() {
+      try {
+        session->ProcessImage(*image_ptr);
+        promise->set_value(std::unique_ptr<OCRStudioSDKResult>(
+            session->CurrentResult().DeepCopy()));
+      } catch (...) {
+        promise->set_exception(std::current_exception());
+      }
+    });
+    return future;
+  }
+
+  /**
+   * @brief Queues an image for processing with a completion callback
+   * @param image - the input image, must remain valid until one of the
+   *        delegate methods is called
+   * @param delegate - completion delegate, not null, must remain valid
+   *        until one of its methods is called. Exceptions thrown by the
+   *        delegate methods are ignored, so that the worker keeps processing
+   *        the queue.
+   */
+  void ProcessImageAsync(
+      const OCRStudioSDKImage& image, OCRStudioSDKResultDelegate* delegate) {
+    if (!delegate) {
+      throw OCRStudioSDKException(
+          "InvalidArgumentException", "The delegate must not be null");
+    }
+    OCRStudioSDKSession* session = session_.get();
+    const OCRStudioSDKImage* image_ptr = &image;
+    Enqueue([session, image_ptr, delegate]() {
+      try {
+        session->ProcessImage(*image_ptr);
+      } catch (const OCRStudioSDKException& e) {
+        delegate->ErrorCallback(e);
+        return;
+      } catch (const std::exception& e) {
+        delegate->ErrorCallback(OCRStudioSDKException("InternalException", e.what()));
+        return;
+      } catch (...) {
+        delegate->ErrorCallback(OCRStudioSDKException(
+            "InternalException", "Unknown exception while processing the image"));
+        return;
+      }
+      delegate->ResultCallback(session->CurrentResult());
+    });
+  }
+
+  /**
+   * @brief Blocks until all queued images are processed
+   */
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return tasks_.empty() && !busy_; });
+  }
+
+  /**
+   * @brief Returns the wrapped session. It may be used directly (e.g. for
+   *        Reset() or CurrentResult()) only while no images are queued,
+   *        see Wait().
+   */
+  OCRStudioSDKSession& Session() {
+    return *session_;
+  }
+
+private:
+  /// Adds a task to the worker queue
+  void Enqueue(const std::function<void()>& task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(task);
+    }
+    queue_cv_.notify_one();
+  }
+
+  /// Worker loop: runs queued tasks until stopped and the queue is empty
+  void RunWorker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      queue_cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty())
+        break;
+      std::function<void()> task = tasks_.front();
+      tasks_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      try {
+        task();
+      } catch (...) {
+        // Exceptions of completion delegates must not stop the worker
+      }
+      lock.lock();
+      busy_ = false;
+      if (tasks_.empty())
+        idle_cv_.notify_all();
+    }
+  }
+
+private:
+  std::unique_ptr<OCRStudioSDKSession> session_; ///< wrapped session
+
+  std::mutex mutex_;                         ///< guards the fields below
+  std::condition_variable queue_cv_;         ///< signals new tasks or stop
+  std::condition_variable idle_cv_;          ///< signals an empty queue
+  std::deque<std::function<void()> > tasks_; ///< pending tasks
+  bool busy_;                                ///< a task is running
+  bool stopping_;                            ///< destructor was called
+
+  std::thread worker_;                       ///< worker thread
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_ASYNC_SESSION_H_INCLUDED
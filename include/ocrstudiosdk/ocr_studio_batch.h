@@ -0,0 +1,176 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_batch.h
+ * @brief Multi-threaded batch processing of independent images
+ *        (header-only, built on top of the public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_BATCH_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_BATCH_H_INCLUDED
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_instance.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Outcome of processing a single image of a batch. Exactly one of
+ *        the fields is set.
+ */
+struct OCRStudioSDKBatchItemResult {
+  /// Final session result for the image (owned)
+  std::unique_ptr<OCRStudioSDKResult> result;
+
+  /// Exception thrown while processing the image (owned)
+  std::unique_ptr<OCRStudioSDKException> error;
+};
+
+/**
+ * @brief Processes batches of independent images on a set of worker threads.
+ *        Each worker owns one session created from the instance, so the
+ *        engine configuration is shared and only per-session state is
+ *        duplicated. Sessions are created on first use and reused by
+ *        subsequent batches, being reset before each image. Images are
+ *        handed out to workers one at a time, so large and small images are
+ *        balanced across threads regardless of their order in the batch.
+ *        The processor must not be used from several threads at once.
+ */
+class OCRStudioSDKBatchProcessor {
+public:
+  /**
+   * @brief Main constructor
+   * @param instance - engine instance, must outlive the processor
+   * @param authorization_signature - signature of an authorized SDK user
+   * @param json_session_params - parameters of the worker sessions, see
+   *        OCRStudioSDKInstance::CreateSession()
+   * @param num_threads - number of worker threads (0 for the number of
+   *        hardware threads)
+   */
+  OCRStudioSDKBatchProcessor(
+      const OCRStudioSDKInstance& instance,
+      const char*                 authorization_signature,
+      const char*                 json_session_params,
+      int                         num_threads = 0)
+    : instance_(instance),
+      signature_(authorization_signature),
+      session_params_(json_session_params) {
+    if (num_threads <= 0)
+      num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    sessions_.resize(num_threads > 0 ? num_threads : 1);
+  }
+
+  /// Number of worker threads
+  int NumThreads() const {
+    return static_cast<int>(sessions_.size());
+  }
+
+  /**
+   * @brief Processes a batch of images, blocking until all of them are done
+   * @param images - input images, must remain valid during the call
+   * @param images_count - number of input images
+   * @return Per-image results, in the order of the input images
+   */
+  std::vector<OCRStudioSDKBatchItemResult> ProcessBatch(
+      const OCRStudioSDKImage* const* images, int images_count) {
+    std::vector<OCRStudioSDKBatchItemResult> results(
+        images_count > 0 ? images_count : 0);
+    if (images_count <= 0)
+      return results;
+
+    const int num_workers =
+        images_count < NumThreads() ? images_count : NumThreads();
+    // Sessions are created sequentially on the calling thread: session
+    // creation errors (e.g. an invalid signature) concern the whole batch
+    // and are propagated to the caller directly
+    for (int i = 0; i < num_workers; ++i) {
+      if (!sessions_[i])
+        sessions_[i].reset(instance_.CreateSession(
+            signature_.c_str(), session_params_.c_str()));
+    }
+
+    std::atomic<int> next_image(0);
+    if (num_workers == 1) {
+      RunWorker(*sessions_[0], images, images_count, next_image, results);
+      return results;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    try {
+      for (int i = 0; i < num_workers; ++i) {
+        workers.emplace_back(
+            &OCRStudioSDKBatchProcessor::RunWorker, this,
+            std::ref(*sessions_[i]), images, images_count,
+            std::ref(next_image), std::ref(results));
+      }
+    } catch (...) {
+      // Started workers must be joined before the vector is destroyed; they
+      // process the whole batch, as they take images until none is left
+      for (size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+      throw;
+    }
+    for (size_t i = 0; i < workers.size(); ++i)
+      workers[i].join();
+
+    return results;
+  }
+
+  /// Convenience overload of ProcessBatch() for a vector of images
+  std::vector<OCRStudioSDKBatchItemResult> ProcessBatch(
+      const std::vector<const OCRStudioSDKImage*>& images) {
+    return ProcessBatch(images.data(), static_cast<int>(images.size()));
+  }
+
+private:
+  /// Worker loop: takes the next unprocessed image until the batch is empty
+  void RunWorker(
+      OCRStudioSDKSession&                      session,
+      const OCRStudioSDKImage* const*           images,
+      int                                       images_count,
+      std::atomic<int>&                         next_image,
+      std::vector<OCRStudioSDKBatchItemResult>& results) {
+    for (int i = next_image++; i < images_count; i = next_image++) {
+      OCRStudioSDKBatchItemResult& item_result = results[i];
+      try {
+        session.Reset();
+        session.ProcessImage(*images[i]);
+        item_result.result.reset(session.CurrentResult().DeepCopy());
+      } catch (const OCRStudioSDKException& e) {
+        item_result.error.reset(new OCRStudioSDKException(e));
+      } catch (const std::exception& e) {
+        item_result.result.reset();
+        item_result.error.reset(new OCRStudioSDKException("InternalException", e.what()));
+      } catch (...) {
+        item_result.result.reset();
+        item_result.error.reset(new OCRStudioSDKException(
+            "InternalException", "Unknown exception while processing the image"));
+      }
+    }
+  }
+
+private:
+  const OCRStudioSDKInstance& instance_;  ///< engine instance
+  std::string signature_;                 ///< authorization signature
+  std::string session_params_;            ///< worker session parameters
+
+  /// Worker sessions, one per thread, created on first use
+  std::vector<std::unique_ptr<OCRStudioSDKSession> > sessions_;
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_BATCH_H_INCLUDED
@@ -0,0 +1,630 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_binary_result.h
+ * @brief Compact binary encoding of results and a reader accessing the
+ *        encoded buffer in place (header-only, built on top of the public
+ *        result interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_BINARY_RESULT_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_BINARY_RESULT_H_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_result.h>
+#include <ocrstudiosdk/ocr_studio_image.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_image_ops.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Encoding of item images in binary results
+ */
+enum OCRStudioSDKBinaryImageEncoding {
+  OCRSTUDIOSDK_BINARY_IMAGES_EXCLUDE = 0,  ///< Images are omitted
+  OCRSTUDIOSDK_BINARY_IMAGES_RAW,          ///< Pixels, no encoding cost; 8-bit
+                                           ///< channels only, see PixelView()
+  OCRSTUDIOSDK_BINARY_IMAGES_JPEG          ///< JPEG bytes, compact
+};
+
+namespace detail {
+
+/// Version of the binary result layout written by EncodeBinaryResult()
+const uint16_t kBinaryResultVersion = 1;
+
+/// Record sizes of the binary result layout, see EncodeBinaryResult()
+const uint32_t kBinaryResultHeaderSize = 24;
+const uint32_t kBinaryResultTargetSize = 24;
+const uint32_t kBinaryResultTypeSize = 16;
+const uint32_t kBinaryResultItemSize = 48;
+const uint32_t kBinaryResultImageSize = 24;
+
+inline void PutU32(std::vector<unsigned char>& out, size_t pos, uint32_t value) {
+  for (int i = 0; i < 4; ++i)
+    out[pos + i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+inline uint32_t GetU32(const unsigned char* pos) {
+  return static_cast<uint32_t>(pos[0]) | (static_cast<uint32_t>(pos[1]) << 8) |
+         (static_cast<uint32_t>(pos[2]) << 16) | (static_cast<uint32_t>(pos[3]) << 24);
+}
+
+/// Decodes standard base64, ignoring invalid characters and padding
+inline void DecodeBase64(const char* data, size_t size, std::vector<unsigned char>& out) {
+  out.clear();
+  out.reserve(size / 4 * 3);
+  uint32_t bits = 0;
+  int bits_count = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const char c = data[i];
+    int value;
+    if (c >= 'A' && c <= 'Z')
+      value = c - 'A';
+    else if (c >= 'a' && c <= 'z')
+      value = c - 'a' + 26;
+    else if (c >= '0' && c <= '9')
+      value = c - '0' + 52;
+    else if (c == '+' || c == '-')
+      value = 62;
+    else if (c == '/' || c == '_')
+      value = 63;
+    else
+      continue;
+    bits = (bits << 6) | static_cast<uint32_t>(value);
+    bits_count += 6;
+    if (bits_count >= 8) {
+      bits_count -= 8;
+      out.push_back(static_cast<unsigned char>(bits >> bits_count));
+    }
+  }
+}
+
+/// Writes records and strings of a binary result, see EncodeBinaryResult()
+class BinaryResultEncoder {
+public:
+  BinaryResultEncoder(std::vector<unsigned char>& out,
+                      OCRStudioSDKBinaryImageEncoding images)
+    : out_(out),
+      images_(images) {}
+
+  void Encode(const OCRStudioSDKResult& result) {
+    // The first pass counts the items, so that all fixed-size records can
+    // be laid out before the variable-size data. Items are only accessed
+    // while their iterator is alive, so the second pass iterates again.
+    const int targets_count = result.TargetsCount();
+    targets_.resize(targets_count);
+    size_t types_count = 0, items_count = 0;
+    for (int target_index = 0; target_index < targets_count; ++target_index) {
+      const OCRStudioSDKTarget& target = result.TargetByIndex(target_index);
+      TargetInfo& info = targets_[target_index];
+      info.target = &target;
+      ExtractJSONStringArray(target.Description(), "item_types", info.item_types);
+      info.items_counts.assign(info.item_types.size(), 0);
+      for (size_t i = 0; i < info.item_types.size(); ++i) {
+        const char* item_type = info.item_types[i].c_str();
+        for (OCRStudioSDKItemIterator it = target.ItemsBegin(item_type),
+             end = target.ItemsEnd(item_type); it != end; it.Step())
+          ++info.items_counts[i];
+        items_count += info.items_counts[i];
+      }
+      types_count += info.item_types.size();
+    }
+
+    const size_t targets_offset = kBinaryResultHeaderSize;
+    size_t types_offset = targets_offset + targets_count * kBinaryResultTargetSize;
+    size_t items_offset = types_offset + types_count * kBinaryResultTypeSize;
+    out_.clear();
+    out_.resize(items_offset + items_count * kBinaryResultItemSize);
+
+    std::memcpy(&out_[0], "OSRB", 4);
+    out_[4] = static_cast<unsigned char>(kBinaryResultVersion);
+    out_[5] = static_cast<unsigned char>(kBinaryResultVersion >> 8);
+    out_[6] = result.AllTargetsFinal() ? 1 : 0;
+    out_[7] = 0;
+    PutU32(out_, 12, static_cast<uint32_t>(targets_count));
+    PutU32(out_, 16, static_cast<uint32_t>(targets_offset));
+    PutU32(out_, 20, 0);
+
+    for (int target_index = 0; target_index < targets_count; ++target_index) {
+      const TargetInfo& info = targets_[target_index];
+      const size_t record = targets_offset + target_index * kBinaryResultTargetSize;
+      PutString(record, info.target->Description());
+      PutU32(out_, record + 8, info.target->IsFinal() ? 1 : 0);
+      PutU32(out_, record + 12, static_cast<uint32_t>(info.item_types.size()));
+      PutU32(out_, record + 16, static_cast<uint32_t>(types_offset));
+      PutU32(out_, record + 20, 0);
+      for (size_t i = 0; i < info.item_types.size(); ++i, types_offset += kBinaryResultTypeSize) {
+        PutString(types_offset, info.item_types[i].c_str());
+        PutU32(out_, types_offset + 8, static_cast<uint32_t>(info.items_counts[i]));
+        PutU32(out_, types_offset + 12, static_cast<uint32_t>(items_offset));
+        const char* item_type = info.item_types[i].c_str();
+        size_t j = 0;
+        for (OCRStudioSDKItemIterator it = info.target->ItemsBegin(item_type),
+             end = info.target->ItemsEnd(item_type);
+             it != end && j < info.items_counts[i]; it.Step(), ++j)
+          PutItem(items_offset + j * kBinaryResultItemSize, it.Item());
+        items_offset += info.items_counts[i] * kBinaryResultItemSize;
+      }
+    }
+    if (out_.size() > UINT32_MAX) {
+      throw OCRStudioSDKException(
+          "InvalidArgumentException", "The result is too large for the binary encoding");
+    }
+    PutU32(out_, 8, static_cast<uint32_t>(out_.size()));
+  }
+
+private:
+  void PutItem(size_t record, const OCRStudioSDKItem& item) {
+    PutString(record, item.Name());
+    PutString(record + 8, item.Value());
+    PutString(record + 16, item.Attributes());
+    PutString(record + 24, item.Description());
+    const double confidence = item.Confidence();
+    uint64_t confidence_bits;
+    std::memcpy(&confidence_bits, &confidence, sizeof(confidence_bits));
+    PutU32(out_, record + 32, static_cast<uint32_t>(confidence_bits));
+    PutU32(out_, record + 36, static_cast<uint32_t>(confidence_bits >> 32));
+    PutU32(out_, record + 40, item.Accepted() ? 1 : 0);
+    PutU32(out_, record + 44, item.HasImage() && images_ != OCRSTUDIOSDK_BINARY_IMAGES_EXCLUDE
+                              ? PutImage(item.Image()) : 0);
+  }
+
+  /// Appends an image record and its data, returns its offset. The record
+  /// is aligned and padded to 8 bytes, so the data is 8-byte aligned too.
+  uint32_t PutImage(const OCRStudioSDKImage& image) {
+    Align(8);
+    const size_t record = out_.size();
+    out_.resize(record + kBinaryResultImageSize);
+    PutU32(out_, record, static_cast<uint32_t>(images_));
+    PutU32(out_, record + 4, static_cast<uint32_t>(image.Width()));
+    PutU32(out_, record + 8, static_cast<uint32_t>(image.Height()));
+    PutU32(out_, record + 12, static_cast<uint32_t>(image.Channels()));
+    PutU32(out_, record + 20, 0);
+    if (images_ == OCRSTUDIOSDK_BINARY_IMAGES_JPEG) {
+      const OCRStudioSDKString base64 = image.ExportBase64JPEG();
+      DecodeBase64(base64.CStr(), static_cast<size_t>(base64.Size()), scratch_);
+      out_.insert(out_.end(), scratch_.begin(), scratch_.end());
+      PutU32(out_, record + 16, static_cast<uint32_t>(scratch_.size()));
+    } else {
+      const OCRStudioSDKPixelView view = PixelView(image);
+      const size_t row_size = static_cast<size_t>(view.width) * view.channels;
+      for (int y = 0; y < view.height; ++y) {
+        const unsigned char* row = view.data + static_cast<ptrdiff_t>(y) * view.bytes_per_line;
+        out_.insert(out_.end(), row, row + row_size);
+      }
+      PutU32(out_, record + 16, static_cast<uint32_t>(row_size * view.height));
+    }
+    return static_cast<uint32_t>(record);
+  }
+
+  /// Appends a NUL-terminated string and writes its reference (offset and
+  /// length) into a record
+  void PutString(size_t record, const char* str) {
+    const size_t length = str ? std::strlen(str) : 0;
+    PutU32(out_, record, static_cast<uint32_t>(out_.size()));
+    PutU32(out_, record + 4, static_cast<uint32_t>(length));
+    if (length)
+      out_.insert(out_.end(), str, str + length);
+    out_.push_back('\0');
+  }
+
+  void Align(size_t alignment) {
+    out_.resize((out_.size() + alignment - 1) / alignment * alignment);
+  }
+
+private:
+  struct TargetInfo {
+    const OCRStudioSDKTarget* target;     ///< target
+    std::vector<std::string> item_types;  ///< item types
+    std::vector<size_t> items_counts;     ///< number of items per type
+  };
+
+  std::vector<unsigned char>& out_;         ///< output buffer
+  OCRStudioSDKBinaryImageEncoding images_;  ///< image encoding
+  std::vector<TargetInfo> targets_;         ///< collected targets
+  std::vector<unsigned char> scratch_;      ///< decoded JPEG buffer
+};
+
+} // namespace detail
+
+
+
+/**
+ * @brief Encodes a result into a versioned binary layout which a reader
+ *        accesses in place, see OCRStudioSDKBinaryResultView. Strings are
+ *        stored as is and images as pixels or JPEG bytes, so encoding needs
+ *        no JSON formatting or base64, and reading needs no parsing.
+ *
+ *        Layout, version 1, integers little-endian, offsets from the start
+ *        of the buffer, strings referenced as (u32 offset, u32 length) and
+ *        NUL-terminated:
+ *          header (24): "OSRB", u16 version, u8 all_targets_final, u8 0,
+ *            u32 total size, u32 targets count, u32 targets offset, u32 0
+ *          target (24): str description, u32 is_final, u32 item types
+ *            count, u32 item types offset, u32 0
+ *          item type (16): str type, u32 items count, u32 items offset
+ *          item (48): str name, str value, str attributes, str description,
+ *            f64 confidence, u32 accepted, u32 image offset (0 if none)
+ *          image (24, 8-byte aligned): u32 encoding, u32 width, u32 height,
+ *            u32 channels, u32 data size, u32 0, then the data (rows without
+ *            padding, or JPEG)
+ *        Readers reject buffers of other versions.
+ * @param result - the result to be encoded
+ * @param out - output buffer, replaced
+ * @param images - encoding of item images
+ */
+inline void EncodeBinaryResult(
+    const OCRStudioSDKResult&       result,
+    std::vector<unsigned char>&     out,
+    OCRStudioSDKBinaryImageEncoding images = OCRSTUDIOSDK_BINARY_IMAGES_JPEG) {
+  detail::BinaryResultEncoder(out, images).Encode(result);
+}
+
+
+
+/**
+ * @brief Read-only view of an item of an encoded result, mirroring
+ *        OCRStudioSDKItem. Strings point into the encoded buffer.
+ */
+class OCRStudioSDKBinaryItemView {
+public:
+  /// Returns the item type
+  const char* Type() const {
+    return type_;
+  }
+
+  /// Returns the item name
+  const char* Name() const {
+    return String(0);
+  }
+
+  /// Returns the item value
+  const char* Value() const {
+    return String(8);
+  }
+
+  /// Returns the item confidence
+  double Confidence() const {
+    const uint64_t bits = detail::GetU32(record_ + 32) |
+        (static_cast<uint64_t>(detail::GetU32(record_ + 36)) << 32);
+    double confidence;
+    std::memcpy(&confidence, &bits, sizeof(confidence));
+    return confidence;
+  }
+
+  /// Returns true iff the item is accepted
+  bool Accepted() const {
+    return detail::GetU32(record_ + 40) != 0;
+  }
+
+  /// Returns the item attributes in JSON format
+  const char* Attributes() const {
+    return String(16);
+  }
+
+  /// Returns the item description in JSON format
+  const char* Description() const {
+    return String(24);
+  }
+
+  /// Returns true iff the item has an encoded image
+  bool HasImage() const {
+    return detail::GetU32(record_ + 44) != 0;
+  }
+
+  /// Returns the encoding of the item image
+  OCRStudioSDKBinaryImageEncoding ImageEncoding() const {
+    return HasImage() ? static_cast<OCRStudioSDKBinaryImageEncoding>(detail::GetU32(Image()))
+                      : OCRSTUDIOSDK_BINARY_IMAGES_EXCLUDE;
+  }
+
+  /**
+   * @brief Returns the pixels of a raw encoded image in place. The view
+   *        must not be written to.
+   */
+  OCRStudioSDKPixelView ImagePixels() const {
+    if (ImageEncoding() != OCRSTUDIOSDK_BINARY_IMAGES_RAW)
+      throw OCRStudioSDKException("InvalidStateException", "The item has no raw image");
+    const unsigned char* image = Image();
+    OCRStudioSDKPixelView view;
+    view.data = const_cast<unsigned char*>(image + detail::kBinaryResultImageSize);
+    view.width = static_cast<int>(detail::GetU32(image + 4));
+    view.height = static_cast<int>(detail::GetU32(image + 8));
+    view.channels = static_cast<int>(detail::GetU32(image + 12));
+    view.bytes_per_line = view.width * view.channels;
+    return view;
+  }
+
+  /// Returns the encoded image data in place (pixels or JPEG bytes)
+  const unsigned char* ImageData() const {
+    return HasImage() ? Image() + detail::kBinaryResultImageSize : nullptr;
+  }
+
+  /// Returns the size of the encoded image data in bytes
+  size_t ImageDataSize() const {
+    return HasImage() ? detail::GetU32(Image() + 16) : 0;
+  }
+
+  /**
+   * @brief Creates an image from the encoded image data
+   * @return Pointer to a new image, the ownership is relinquished.
+   */
+  OCRStudioSDKImage* CreateImage() const {
+    if (ImageEncoding() == OCRSTUDIOSDK_BINARY_IMAGES_RAW) {
+      const OCRStudioSDKPixelView view = ImagePixels();
+      return OCRStudioSDKImage::CreateFromBuffer(
+          view.data, static_cast<int>(ImageDataSize()),
+          view.width, view.height, view.bytes_per_line, view.channels);
+    }
+    if (ImageEncoding() == OCRSTUDIOSDK_BINARY_IMAGES_JPEG) {
+      return OCRStudioSDKImage::CreateFromFileBuffer(
+          const_cast<unsigned char*>(ImageData()), static_cast<int>(ImageDataSize()));
+    }
+    throw OCRStudioSDKException("InvalidStateException", "The item has no image");
+  }
+
+private:
+  friend class OCRStudioSDKBinaryTargetView;
+
+  OCRStudioSDKBinaryItemView(const unsigned char* base, const unsigned char* record,
+                             const char* type)
+    : base_(base),
+      record_(record),
+      type_(type) {}
+
+  const char* String(size_t field) const {
+    return reinterpret_cast<const char*>(base_ + detail::GetU32(record_ + field));
+  }
+
+  const unsigned char* Image() const {
+    return base_ + detail::GetU32(record_ + 44);
+  }
+
+private:
+  const unsigned char* base_;    ///< encoded buffer
+  const unsigned char* record_;  ///< item record
+  const char* type_;             ///< item type
+};
+
+
+
+/**
+ * @brief Read-only view of a target of an encoded result, mirroring
+ *        OCRStudioSDKTarget. Items are accessed by type and index instead of
+ *        iterators.
+ */
+class OCRStudioSDKBinaryTargetView {
+public:
+  /// Returns the target description in JSON format
+  const char* Description() const {
+    return reinterpret_cast<const char*>(base_ + detail::GetU32(record_));
+  }
+
+  /// Returns true iff the target is final
+  bool IsFinal() const {
+    return detail::GetU32(record_ + 8) != 0;
+  }
+
+  /// Returns the number of item types
+  int ItemTypesCount() const {
+    return static_cast<int>(detail::GetU32(record_ + 12));
+  }
+
+  /// Returns an item type by index
+  const char* ItemType(int type_index) const {
+    return reinterpret_cast<const char*>(base_ + detail::GetU32(TypeRecord(type_index)));
+  }
+
+  /// Returns the number of items of a type (0 for unknown types)
+  int ItemsCountByType(const char* item_type) const {
+    const unsigned char* type = FindType(item_type);
+    return type ? static_cast<int>(detail::GetU32(type + 8)) : 0;
+  }
+
+  /// Returns true iff there is an item with the given type and name
+  bool HasItem(const char* item_type, const char* item_name) const {
+    return FindItem(item_type, item_name) != nullptr;
+  }
+
+  /// Returns an item by type and name
+  OCRStudioSDKBinaryItemView Item(const char* item_type, const char* item_name) const {
+    const unsigned char* item = FindItem(item_type, item_name);
+    if (!item) {
+      throw OCRStudioSDKException(
+          "InvalidArgumentException",
+          ("No item " + std::string(item_type) + "/" + item_name).c_str());
+    }
+    return OCRStudioSDKBinaryItemView(base_, item, TypeName(FindType(item_type)));
+  }
+
+  /// Returns an item by type and index, in the order of the encoded result
+  OCRStudioSDKBinaryItemView ItemByIndex(const char* item_type, int item_index) const {
+    const unsigned char* type = FindType(item_type);
+    if (!type || item_index < 0 || item_index >= static_cast<int>(detail::GetU32(type + 8))) {
+      throw OCRStudioSDKException(
+          "InvalidArgumentException",
+          ("No item " + std::string(item_type) + "/" + std::to_string(item_index)).c_str());
+    }
+    return OCRStudioSDKBinaryItemView(
+        base_, base_ + detail::GetU32(type + 12) + item_index * detail::kBinaryResultItemSize,
+        TypeName(type));
+  }
+
+private:
+  friend class OCRStudioSDKBinaryResultView;
+
+  OCRStudioSDKBinaryTargetView(const unsigned char* base, const unsigned char* record)
+    : base_(base),
+      record_(record) {}
+
+  const unsigned char* TypeRecord(int type_index) const {
+    if (type_index < 0 || type_index >= ItemTypesCount()) {
+      throw OCRStudioSDKException(
+          "InvalidArgumentException", "Item type index is out of range");
+    }
+    return base_ + detail::GetU32(record_ + 16) + type_index * detail::kBinaryResultTypeSize;
+  }
+
+  const char* TypeName(const unsigned char* type) const {
+    return reinterpret_cast<const char*>(base_ + detail::GetU32(type));
+  }
+
+  const unsigned char* FindType(const char* item_type) const {
+    for (int i = 0; i < ItemTypesCount(); ++i) {
+      const unsigned char* type = TypeRecord(i);
+      if (std::strcmp(TypeName(type), item_type) == 0)
+        return type;
+    }
+    return nullptr;
+  }
+
+  const unsigned char* FindItem(const char* item_type, const char* item_name) const {
+    const unsigned char* type = FindType(item_type);
+    if (!type)
+      return nullptr;
+    const unsigned char* item = base_ + detail::GetU32(type + 12);
+    for (uint32_t i = detail::GetU32(type + 8); i > 0; --i, item += detail::kBinaryResultItemSize) {
+      if (std::strcmp(reinterpret_cast<const char*>(base_ + detail::GetU32(item)), item_name) == 0)
+        return item;
+    }
+    return nullptr;
+  }
+
+private:
+  const unsigned char* base_;    ///< encoded buffer
+  const unsigned char* record_;  ///< target record
+};
+
+
+
+/**
+ * @brief Read-only view of a result encoded by EncodeBinaryResult(),
+ *        mirroring OCRStudioSDKResult. The constructor validates the layout
+ *        (record and string bounds, string terminators) without copying, and
+ *        accessors then read the buffer in place. The buffer must outlive
+ *        the view and the views obtained from it.
+ */
+class OCRStudioSDKBinaryResultView {
+public:
+  /**
+   * @brief Main constructor
+   * @param data - pointer to the encoded result
+   * @param size - size of the encoded result in bytes
+   */
+  OCRStudioSDKBinaryResultView(const unsigned char* data, size_t size)
+    : base_(data),
+      size_(size) {
+    Validate();
+  }
+
+  /// Returns the number of targets
+  int TargetsCount() const {
+    return static_cast<int>(detail::GetU32(base_ + 12));
+  }
+
+  /// Returns a target by index
+  OCRStudioSDKBinaryTargetView TargetByIndex(int target_index) const {
+    if (target_index < 0 || target_index >= TargetsCount()) {
+      throw OCRStudioSDKException(
+          "InvalidArgumentException", "Target index is out of range");
+    }
+    return OCRStudioSDKBinaryTargetView(
+        base_, base_ + detail::GetU32(base_ + 16) + target_index * detail::kBinaryResultTargetSize);
+  }
+
+  /// Returns true iff all targets are final
+  bool AllTargetsFinal() const {
+    return base_[6] != 0;
+  }
+
+private:
+  void Validate() const {
+    if (!base_ || size_ < detail::kBinaryResultHeaderSize || std::memcmp(base_, "OSRB", 4) != 0)
+      Fail("not a binary result");
+    if ((base_[4] | (base_[5] << 8)) != detail::kBinaryResultVersion)
+      Fail("unsupported version");
+    if (detail::GetU32(base_ + 8) != size_)
+      Fail("size mismatch");
+    const uint32_t targets_count = detail::GetU32(base_ + 12);
+    const uint32_t targets_offset = detail::GetU32(base_ + 16);
+    CheckRange(targets_offset, targets_count, detail::kBinaryResultTargetSize);
+    for (uint32_t t = 0; t < targets_count; ++t) {
+      const uint32_t target = targets_offset + t * detail::kBinaryResultTargetSize;
+      CheckString(target);
+      const uint32_t types_count = detail::GetU32(base_ + target + 12);
+      const uint32_t types_offset = detail::GetU32(base_ + target + 16);
+      CheckRange(types_offset, types_count, detail::kBinaryResultTypeSize);
+      for (uint32_t k = 0; k < types_count; ++k) {
+        const uint32_t type = types_offset + k * detail::kBinaryResultTypeSize;
+        CheckString(type);
+        const uint32_t items_count = detail::GetU32(base_ + type + 8);
+        const uint32_t items_offset = detail::GetU32(base_ + type + 12);
+        CheckRange(items_offset, items_count, detail::kBinaryResultItemSize);
+        for (uint32_t i = 0; i < items_count; ++i) {
+          const uint32_t item = items_offset + i * detail::kBinaryResultItemSize;
+          for (uint32_t field = 0; field < 32; field += 8)
+            CheckString(item + field);
+          const uint32_t image = detail::GetU32(base_ + item + 44);
+          if (image)
+            CheckImage(image);
+        }
+      }
+    }
+  }
+
+  /// Checks that an array of records lies within the buffer
+  void CheckRange(uint64_t offset, uint64_t count, uint64_t record_size) const {
+    if (offset > size_ || count * record_size > size_ - offset)
+      Fail("record out of bounds");
+  }
+
+  /// Checks a string reference at a position of a checked record
+  void CheckString(uint32_t reference) const {
+    const uint64_t offset = detail::GetU32(base_ + reference);
+    const uint64_t length = detail::GetU32(base_ + reference + 4);
+    if (offset + length >= size_ || base_[offset + length] != '\0')
+      Fail("string out of bounds");
+  }
+
+  void CheckImage(uint32_t image) const {
+    CheckRange(image, 1, detail::kBinaryResultImageSize);
+    const uint32_t encoding = detail::GetU32(base_ + image);
+    const uint64_t data_size = detail::GetU32(base_ + image + 16);
+    if (data_size > size_ - image - detail::kBinaryResultImageSize)
+      Fail("image out of bounds");
+    if (encoding == OCRSTUDIOSDK_BINARY_IMAGES_RAW) {
+      const uint64_t width = detail::GetU32(base_ + image + 4);
+      const uint64_t height = detail::GetU32(base_ + image + 8);
+      const uint64_t channels = detail::GetU32(base_ + image + 12);
+      if (width == 0 || height == 0 || channels == 0 || width * channels > INT32_MAX ||
+          width * channels * height != data_size)
+        Fail("invalid raw image");
+    } else if (encoding != OCRSTUDIOSDK_BINARY_IMAGES_JPEG) {
+      Fail("unknown image encoding");
+    }
+  }
+
+  static void Fail(const char* reason) {
+    throw OCRStudioSDKException(
+        "InvalidArgumentException",
+        ("Invalid binary result: " + std::string(reason)).c_str());
+  }
+
+private:
+  const unsigned char* base_;  ///< encoded buffer
+  const size_t size_;          ///< size of the buffer
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_BINARY_RESULT_H_INCLUDED
@@ -0,0 +1,377 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_buffer_pool.h
+ * @brief Size-class pool of byte buffers with per-thread caches
+ *        (header-only)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_BUFFER_POOL_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_BUFFER_POOL_H_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_image.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Counters of the buffer pool
+ */
+struct OCRStudioSDKBufferPoolStats {
+  long long acquisitions;       ///< Buffers handed out
+  long long thread_cache_hits;  ///< Served from the calling thread's cache
+  long long shared_hits;        ///< Served from the shared lists
+  long long heap_allocations;   ///< Served by a new heap allocation
+  long long bytes_in_use;       ///< Capacity of buffers currently handed out
+  long long bytes_cached;       ///< Capacity of buffers kept in the shared lists
+                                ///< and the thread caches
+};
+
+class OCRStudioSDKBufferPool;
+
+
+
+/**
+ * @brief Buffer handed out by OCRStudioSDKBufferPool, returned to the pool
+ *        on destruction. Movable, non-copyable.
+ */
+class OCRStudioSDKPooledBuffer {
+public:
+  /// Constructs an empty buffer
+  OCRStudioSDKPooledBuffer()
+    : data_(nullptr), size_(0), size_class_(-1) {}
+
+  /// Move constructor
+  OCRStudioSDKPooledBuffer(OCRStudioSDKPooledBuffer&& other)
+    : data_(other.data_), size_(other.size_), size_class_(other.size_class_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.size_class_ = -1;
+  }
+
+  /// Move assignment, returns the currently held buffer to the pool
+  inline OCRStudioSDKPooledBuffer& operator =(OCRStudioSDKPooledBuffer&& other);
+
+  OCRStudioSDKPooledBuffer(const OCRStudioSDKPooledBuffer&) = delete;
+  OCRStudioSDKPooledBuffer& operator =(const OCRStudioSDKPooledBuffer&) = delete;
+
+  /// Destructor, returns the buffer to the pool
+  inline ~OCRStudioSDKPooledBuffer();
+
+  /// Pointer to the buffer memory (uninitialized when acquired)
+  unsigned char* Data() const {
+    return data_;
+  }
+
+  /// Requested size of the buffer in bytes
+  size_t Size() const {
+    return size_;
+  }
+
+  /// Returns true iff the object holds no buffer
+  bool Empty() const {
+    return data_ == nullptr;
+  }
+
+private:
+  friend class OCRStudioSDKBufferPool;
+
+  OCRStudioSDKPooledBuffer(unsigned char* data, size_t size, int size_class)
+    : data_(data), size_(size), size_class_(size_class) {}
+
+  unsigned char* data_;  ///< buffer memory
+  size_t size_;          ///< requested size in bytes
+  int size_class_;       ///< size class, or -1 for unpooled buffers
+};
+
+
+
+/**
+ * @brief Process-wide pool of byte buffers. Requests are rounded up to
+ *        power-of-two size classes (4 KiB to 1 GiB); released buffers of up
+ *        to 1 MiB are first kept in a small cache of the releasing thread,
+ *        other buffers in shared per-class lists. The thread caches and the
+ *        shared lists together are bounded by one byte limit. At steady
+ *        state, repeated requests of the same sizes are served without heap
+ *        allocation, and small requests without lock contention.
+ *
+ *        The pool is meant for the staging buffers that the application
+ *        passes to the SDK repeatedly, such as its own frame buffers, and for
+ *        ExportPixelsToPooledBuffer(). Pixel buffers allocated inside the
+ *        engine are not affected, and the other helpers of this package
+ *        (YUV conversion, image operations, frame quality) keep their own
+ *        per-thread scratch buffers.
+ */
+class OCRStudioSDKBufferPool {
+public:
+  /// Returns the process-wide pool
+  static OCRStudioSDKBufferPool& Instance() {
+    // Intentionally leaked, so that thread caches may be flushed into it
+    // during process shutdown
+    static OCRStudioSDKBufferPool* pool = new OCRStudioSDKBufferPool();
+    return *pool;
+  }
+
+  /**
+   * @brief Acquires a buffer of at least the requested size
+   * @param size - requested size in bytes
+   * @return Buffer handle, returning the memory to the pool on destruction
+   */
+  OCRStudioSDKPooledBuffer Acquire(size_t size) {
+    acquisitions_.fetch_add(1, std::memory_order_relaxed);
+    const int size_class = SizeClass(size);
+    if (size_class < 0) {
+      unsigned char* data = new unsigned char[size];
+      heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+      bytes_in_use_.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+      return OCRStudioSDKPooledBuffer(data, size, -1);
+    }
+    const size_t capacity = ClassCapacity(size_class);
+
+    if (size_class < kThreadCachedClasses) {
+      std::vector<unsigned char*>& local = LocalCache().slots[size_class];
+      if (!local.empty()) {
+        unsigned char* data = local.back();
+        local.pop_back();
+        thread_cached_bytes_.fetch_sub(static_cast<long long>(capacity),
+                                       std::memory_order_relaxed);
+        thread_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+        bytes_in_use_.fetch_add(static_cast<long long>(capacity), std::memory_order_relaxed);
+        return OCRStudioSDKPooledBuffer(data, size, size_class);
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::vector<unsigned char*>& shared = shared_[size_class];
+      if (!shared.empty()) {
+        unsigned char* data = shared.back();
+        shared.pop_back();
+        bytes_cached_ -= static_cast<long long>(capacity);
+        shared_hits_.fetch_add(1, std::memory_order_relaxed);
+        bytes_in_use_.fetch_add(static_cast<long long>(capacity), std::memory_order_relaxed);
+        return OCRStudioSDKPooledBuffer(data, size, size_class);
+      }
+    }
+    // Counted only once the allocation has succeeded
+    unsigned char* data = new unsigned char[capacity];
+    heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+    bytes_in_use_.fetch_add(static_cast<long long>(capacity), std::memory_order_relaxed);
+    return OCRStudioSDKPooledBuffer(data, size, size_class);
+  }
+
+  /**
+   * @brief Sets the limit of memory kept in the shared lists and the thread
+   *        caches. Buffers already cached by other threads are not released.
+   * @param max_cached_bytes - limit in bytes (default 256 MiB)
+   */
+  void SetMaxCachedBytes(long long max_cached_bytes) {
+    if (thread_cached_bytes_.load(std::memory_order_relaxed) > max_cached_bytes)
+      FlushThreadCache(LocalCache(), false);
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_cached_bytes_.store(max_cached_bytes, std::memory_order_relaxed);
+    TrimLocked(max_cached_bytes - thread_cached_bytes_.load(std::memory_order_relaxed));
+  }
+
+  /// Releases all buffers kept in the shared lists and in the cache of the
+  /// calling thread. Caches of other threads are released on their exit.
+  void Trim() {
+    FlushThreadCache(LocalCache(), false);
+    std::lock_guard<std::mutex> lock(mutex_);
+    TrimLocked(0);
+  }
+
+  /// Returns the pool counters
+  OCRStudioSDKBufferPoolStats Stats() const {
+    OCRStudioSDKBufferPoolStats stats;
+    stats.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+    stats.thread_cache_hits = thread_cache_hits_.load(std::memory_order_relaxed);
+    stats.shared_hits = shared_hits_.load(std::memory_order_relaxed);
+    stats.heap_allocations = heap_allocations_.load(std::memory_order_relaxed);
+    stats.bytes_in_use = bytes_in_use_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.bytes_cached = bytes_cached_ + thread_cached_bytes_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+private:
+  static const int kMinClassLog2 = 12;         ///< 4 KiB
+  static const int kMaxClassLog2 = 30;         ///< 1 GiB
+  static const int kNumClasses = kMaxClassLog2 - kMinClassLog2 + 1;
+  static const int kThreadCachedClasses = 9;   ///< classes up to 1 MiB
+  static const size_t kThreadCacheDepth = 4;   ///< buffers per class per thread
+
+  /// Buffers cached by a thread, flushed to the shared lists on thread exit.
+  /// Holds at most kThreadCacheDepth buffers of each class up to 1 MiB, that
+  /// is less than 8 MiB.
+  struct ThreadCache {
+    std::vector<unsigned char*> slots[kThreadCachedClasses];
+
+    ~ThreadCache() {
+      Instance().FlushThreadCache(*this, true);
+    }
+  };
+
+  OCRStudioSDKBufferPool()
+    : acquisitions_(0), thread_cache_hits_(0), shared_hits_(0),
+      heap_allocations_(0), bytes_in_use_(0), thread_cached_bytes_(0),
+      max_cached_bytes_(256LL << 20), bytes_cached_(0) {}
+
+  static ThreadCache& LocalCache() {
+    static thread_local ThreadCache cache;
+    return cache;
+  }
+
+  /// Returns the size class for a request, or -1 if it is not pooled
+  static int SizeClass(size_t size) {
+    int size_class = 0;
+    while ((static_cast<size_t>(1) << (size_class + kMinClassLog2)) < size) {
+      if (++size_class >= kNumClasses)
+        return -1;
+    }
+    return size_class;
+  }
+
+  static size_t ClassCapacity(int size_class) {
+    return static_cast<size_t>(1) << (size_class + kMinClassLog2);
+  }
+
+  /// Returns a buffer handed out by Acquire()
+  void Release(unsigned char* data, size_t size, int size_class) {
+    if (size_class < 0) {
+      bytes_in_use_.fetch_sub(static_cast<long long>(size), std::memory_order_relaxed);
+      delete[] data;
+      return;
+    }
+    bytes_in_use_.fetch_sub(static_cast<long long>(ClassCapacity(size_class)),
+                            std::memory_order_relaxed);
+    if (size_class < kThreadCachedClasses) {
+      std::vector<unsigned char*>& local = LocalCache().slots[size_class];
+      const long long capacity = static_cast<long long>(ClassCapacity(size_class));
+      // The limit is checked without the lock, so concurrent releases may
+      // exceed it by a few small buffers
+      if (local.size() < kThreadCacheDepth &&
+          thread_cached_bytes_.load(std::memory_order_relaxed) + capacity <=
+              max_cached_bytes_.load(std::memory_order_relaxed)) {
+        local.push_back(data);
+        thread_cached_bytes_.fetch_add(capacity, std::memory_order_relaxed);
+        return;
+      }
+    }
+    ReleaseShared(data, size_class);
+  }
+
+  /// Puts a buffer to the shared lists, or frees it if the limit is reached
+  void ReleaseShared(unsigned char* data, int size_class) {
+    const long long capacity = static_cast<long long>(ClassCapacity(size_class));
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (bytes_cached_ + thread_cached_bytes_.load(std::memory_order_relaxed) + capacity <=
+          max_cached_bytes_.load(std::memory_order_relaxed)) {
+        shared_[size_class].push_back(data);
+        bytes_cached_ += capacity;
+        return;
+      }
+    }
+    delete[] data;
+  }
+
+  /// Empties a thread cache, moving its buffers to the shared lists or
+  /// freeing them
+  void FlushThreadCache(ThreadCache& cache, bool keep_buffers) {
+    for (int size_class = 0; size_class < kThreadCachedClasses; ++size_class) {
+      std::vector<unsigned char*>& slots = cache.slots[size_class];
+      const long long capacity = static_cast<long long>(ClassCapacity(size_class));
+      for (size_t i = 0; i < slots.size(); ++i) {
+        thread_cached_bytes_.fetch_sub(capacity, std::memory_order_relaxed);
+        if (keep_buffers)
+          ReleaseShared(slots[i], size_class);
+        else
+          delete[] slots[i];
+      }
+      slots.clear();
+    }
+  }
+
+  /// Frees shared buffers, largest first, until the limit is met
+  void TrimLocked(long long limit) {
+    for (int size_class = kNumClasses - 1;
+         size_class >= 0 && bytes_cached_ > limit; --size_class) {
+      std::vector<unsigned char*>& shared = shared_[size_class];
+      while (!shared.empty() && bytes_cached_ > limit) {
+        delete[] shared.back();
+        shared.pop_back();
+        bytes_cached_ -= static_cast<long long>(ClassCapacity(size_class));
+      }
+    }
+  }
+
+private:
+  friend class OCRStudioSDKPooledBuffer;
+
+  std::atomic<long long> acquisitions_;       ///< see OCRStudioSDKBufferPoolStats
+  std::atomic<long long> thread_cache_hits_;  ///< see OCRStudioSDKBufferPoolStats
+  std::atomic<long long> shared_hits_;        ///< see OCRStudioSDKBufferPoolStats
+  std::atomic<long long> heap_allocations_;   ///< see OCRStudioSDKBufferPoolStats
+  std::atomic<long long> bytes_in_use_;       ///< see OCRStudioSDKBufferPoolStats
+  std::atomic<long long> thread_cached_bytes_; ///< capacity of thread caches
+  std::atomic<long long> max_cached_bytes_;   ///< limit of all cached bytes
+
+  mutable std::mutex mutex_;                  ///< guards the fields below
+  std::vector<unsigned char*> shared_[kNumClasses];  ///< shared free lists
+  long long bytes_cached_;                    ///< capacity of shared buffers
+};
+
+
+
+inline OCRStudioSDKPooledBuffer& OCRStudioSDKPooledBuffer::operator =(
+    OCRStudioSDKPooledBuffer&& other) {
+  if (this != &other) {
+    if (data_)
+      OCRStudioSDKBufferPool::Instance().Release(data_, size_, size_class_);
+    data_ = other.data_;
+    size_ = other.size_;
+    size_class_ = other.size_class_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.size_class_ = -1;
+  }
+  return *this;
+}
+
+inline OCRStudioSDKPooledBuffer::~OCRStudioSDKPooledBuffer() {
+  if (data_)
+    OCRStudioSDKBufferPool::Instance().Release(data_, size_, size_class_);
+}
+
+
+
+/**
+ * @brief Exports the pixels of an image into a pooled buffer, see
+ *        OCRStudioSDKImage::ExportPixelBuffer()
+ * @param image - the source image
+ * @return Buffer holding the exported pixels, Size() is the exported length
+ */
+inline OCRStudioSDKPooledBuffer ExportPixelsToPooledBuffer(
+    const OCRStudioSDKImage& image) {
+  const int length = image.ExportPixelBufferLength();
+  if (length <= 0)
+    return OCRStudioSDKPooledBuffer();
+  OCRStudioSDKPooledBuffer buffer =
+      OCRStudioSDKBufferPool::Instance().Acquire(static_cast<size_t>(length));
+  image.ExportPixelBuffer(buffer.Data(), length);
+  return buffer;
+}
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_BUFFER_POOL_H_INCLUDED
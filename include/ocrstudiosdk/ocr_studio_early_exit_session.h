@@ -0,0 +1,176 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_early_exit_session.h
+ * @brief Video session wrapper which stops processing frames once the result
+ *        has converged (header-only, built on top of the public session
+ *        interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_EARLY_EXIT_SESSION_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_EARLY_EXIT_SESSION_H_INCLUDED
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_session.h>
+#include <ocrstudiosdk/ocr_studio_result.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Session wrapper for video sessions which skips ProcessImage() calls
+ *        once the current result has converged, until Reset(). The result is
+ *        considered converged when there is at least one target and either
+ *        all targets are final or, if a stop confidence is set, every item
+ *        of every target is accepted with at least that confidence.
+ *        Skipped frames cost a single flag check, so the tail of a video
+ *        session after convergence does not run the recognition pipeline.
+ *        ProcessData() calls are always forwarded and neither counted nor
+ *        checked for convergence, which is evaluated after processed frames.
+ */
+class OCRStudioSDKEarlyExitSession : public OCRStudioSDKSession {
+public:
+  /**
+   * @brief Main constructor
+   * @param session - session to be wrapped, the ownership is taken
+   * @param stop_confidence - confidence of accepted items at which the
+   *        result is considered converged before the targets become final
+   *        (negative to only stop on final targets)
+   */
+  explicit OCRStudioSDKEarlyExitSession(OCRStudioSDKSession* session,
+                                        double stop_confidence = -1.0)
+    : session_(session),
+      stop_confidence_(stop_confidence),
+      converged_(false),
+      processed_frames_(0),
+      skipped_frames_(0) {}
+
+  /// Returns true iff the result has converged and frames are skipped
+  bool IsConverged() const {
+    return converged_;
+  }
+
+  /// Returns the number of frames processed since creation or Reset()
+  int ProcessedFrames() const {
+    return processed_frames_;
+  }
+
+  /// Returns the number of frames skipped since creation or Reset()
+  int SkippedFrames() const {
+    return skipped_frames_;
+  }
+
+  /// Returns the wrapped session
+  OCRStudioSDKSession& Session() {
+    return *session_;
+  }
+
+  virtual const char* Description() const override {
+    return session_->Description();
+  }
+
+  virtual void ProcessImage(const OCRStudioSDKImage& image) override {
+    if (converged_) {
+      ++skipped_frames_;
+      return;
+    }
+    session_->ProcessImage(image);
+    ++processed_frames_;
+    converged_ = HasConverged(session_->CurrentResult());
+  }
+
+  virtual void ProcessData(const char* data_str) override {
+    session_->ProcessData(data_str);
+  }
+
+  virtual const OCRStudioSDKResult& CurrentResult() const override {
+    return session_->CurrentResult();
+  }
+
+  virtual void Reset() override {
+    session_->Reset();
+    converged_ = false;
+    processed_frames_ = 0;
+    skipped_frames_ = 0;
+  }
+
+  virtual void Suspend() override {
+    session_->Suspend();
+  }
+
+  virtual void Resume() override {
+    session_->Resume();
+  }
+
+private:
+  /// Item types of a target, kept between frames while its description
+  /// does not change
+  struct TargetItemTypes {
+    std::string description;              ///< description they were read from
+    std::vector<std::string> item_types;  ///< item types of the description
+  };
+
+  /// Returns the item types of the target with the given index, parsing the
+  /// description only when it differs from the one of the previous frame
+  const std::vector<std::string>& ItemTypes(int target_index,
+                                            const OCRStudioSDKTarget& target) {
+    if (static_cast<size_t>(target_index) >= item_types_.size())
+      item_types_.resize(static_cast<size_t>(target_index) + 1);
+    TargetItemTypes& cached = item_types_[static_cast<size_t>(target_index)];
+    const char* description = target.Description();
+    if (cached.description != description) {
+      cached.description = description;
+      detail::ExtractJSONStringArray(description, "item_types", cached.item_types);
+    }
+    return cached.item_types;
+  }
+
+  /// Checks the convergence criteria described in the class comment
+  bool HasConverged(const OCRStudioSDKResult& result) {
+    // An empty result is vacuously "all final", but nothing was found yet
+    if (result.TargetsCount() == 0)
+      return false;
+    if (result.AllTargetsFinal())
+      return true;
+    if (stop_confidence_ < 0.0)
+      return false;
+    for (int target_index = 0; target_index < result.TargetsCount(); ++target_index) {
+      const OCRStudioSDKTarget& target = result.TargetByIndex(target_index);
+      const std::vector<std::string>& item_types = ItemTypes(target_index, target);
+      bool has_items = false;
+      for (size_t i = 0; i < item_types.size(); ++i) {
+        const char* item_type = item_types[i].c_str();
+        for (OCRStudioSDKItemIterator it = target.ItemsBegin(item_type),
+             end = target.ItemsEnd(item_type); it != end; it.Step()) {
+          const OCRStudioSDKItem& item = it.Item();
+          if (!item.Accepted() || item.Confidence() < stop_confidence_)
+            return false;
+          has_items = true;
+        }
+      }
+      if (!has_items)
+        return false;
+    }
+    return true;
+  }
+
+private:
+  std::unique_ptr<OCRStudioSDKSession> session_;  ///< wrapped session
+  const double stop_confidence_;          ///< confidence threshold, or negative
+  bool converged_;                        ///< frames are skipped
+  int processed_frames_;                  ///< frames passed to the session
+  int skipped_frames_;                    ///< frames skipped after convergence
+  std::vector<TargetItemTypes> item_types_;  ///< item types by target index
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_EARLY_EXIT_SESSION_H_INCLUDED
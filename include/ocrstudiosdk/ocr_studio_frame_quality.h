@@ -0,0 +1,407 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_frame_quality.h
+ * @brief Cheap frame quality assessment and a session wrapper rejecting
+ *        blurry, glared, badly exposed and empty frames before recognition
+ *        (header-only, built on top of the public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_FRAME_QUALITY_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_FRAME_QUALITY_H_INCLUDED
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_session.h>
+#include <ocrstudiosdk/ocr_studio_delegate.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+#include <ocrstudiosdk/ocr_studio_image_ops.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Quality scores of a frame, computed on a grayscale copy downscaled
+ *        to at most 320 pixels on the longer side
+ */
+struct OCRStudioSDKFrameQuality {
+  double sharpness;          ///< Variance of the Laplacian
+  double brightness;         ///< Mean brightness, 0..255
+  double contrast;           ///< Standard deviation of the brightness
+  double glare;              ///< Fraction of saturated pixels (>= 250)
+  double edge_density;       ///< Fraction of pixels on edges, a measure of
+                             ///< structure (a document) in view
+  bool accepted;             ///< Whether the frame passed the thresholds
+  const char* reason;        ///< Rejection reason: "underexposed",
+                             ///< "overexposed", "no_document", "glare",
+                             ///< "blurry", or "" if accepted
+  double assessment_us;      ///< Time spent on the assessment
+};
+
+/**
+ * @brief Thresholds of the frame quality assessment. The defaults are
+ *        conservative starting points and should be tuned on the frames of
+ *        the actual cameras.
+ */
+struct OCRStudioSDKFrameQualityThresholds {
+  double min_brightness = 40.0;    ///< Darker frames are underexposed
+  double max_brightness = 225.0;   ///< Brighter frames are overexposed
+  double min_contrast = 12.0;      ///< Flatter frames have no document
+  double min_edge_density = 0.02;  ///< Frames with fewer edges have no document
+  double max_glare = 0.05;         ///< Frames with more saturation have glare
+  double min_sharpness = 60.0;     ///< Frames with less detail are blurry
+};
+
+namespace detail {
+
+/// Maximum size of the longer side of the assessed grayscale copy
+const int kFrameQualityMaxSide = 320;
+
+/// Absolute Laplacian above which a pixel is counted as an edge
+const int kFrameQualityEdgeThreshold = 24;
+
+inline std::vector<unsigned char>& FrameQualityScratchBuffer() {
+  static thread_local std::vector<unsigned char> buffer;
+  return buffer;
+}
+
+/// Downscales 8-bit pixels to grayscale by an integer factor, averaging
+/// 2x2 pixels at each sampling point; channels 1-3 of colour images are
+/// taken as RGB
+inline void DownscaleToGray(const OCRStudioSDKPixelView& src, int factor,
+                            int width, int height, unsigned char* gray) {
+  const int c = src.channels;
+  const int dx = factor > 1 && src.width > 1 ? c : 0;
+  const int dy = factor > 1 && src.height > 1 ? src.bytes_per_line : 0;
+  for (int y = 0; y < height; ++y) {
+    const unsigned char* row = src.data + static_cast<ptrdiff_t>(y) * factor * src.bytes_per_line;
+    unsigned char* out = gray + y * width;
+    if (c >= 3) {
+      for (int x = 0; x < width; ++x) {
+        const unsigned char* p = row + x * factor * c;
+        const int r = p[0] + p[dx] + p[dy] + p[dy + dx];
+        const int g = p[1] + p[dx + 1] + p[dy + 1] + p[dy + dx + 1];
+        const int b = p[2] + p[dx + 2] + p[dy + 2] + p[dy + dx + 2];
+        out[x] = static_cast<unsigned char>((77 * r + 150 * g + 29 * b + 512) >> 10);
+      }
+    } else {
+      for (int x = 0; x < width; ++x) {
+        const unsigned char* p = row + x * factor * c;
+        out[x] = static_cast<unsigned char>((p[0] + p[dx] + p[dy] + p[dy + dx] + 2) >> 2);
+      }
+    }
+  }
+}
+
+/// Accumulates the Laplacian statistics of the pixels [1, width - 1) of a
+/// row: the sum, the sum of squares and the number of edge pixels
+inline void LaplacianRowStats(const unsigned char* up, const unsigned char* mid,
+                              const unsigned char* down, int width,
+                              long long* sum, long long* sum_sq, long long* edges) {
+  int x = 1;
+  // The Laplacian is within [-1020, 1020]; the vector kernels compute it in
+  // 16-bit lanes and accumulate the per-row sums in 32-bit lanes, which
+  // cannot overflow for rows of at most kFrameQualityMaxSide pixels
+#if defined(OCRSTUDIOSDK_IMAGE_OPS_HAVE_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi16(1);
+  const __m128i threshold = _mm_set1_epi16(kFrameQualityEdgeThreshold);
+  __m128i sum_acc = zero, sq_acc = zero, edge_acc = zero;
+  for (; x + 8 < width; x += 8) {
+    const __m128i c = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mid + x)), zero);
+    const __m128i l = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mid + x - 1)), zero);
+    const __m128i r = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mid + x + 1)), zero);
+    const __m128i u = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(up + x)), zero);
+    const __m128i d = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(down + x)), zero);
+    const __m128i lap = _mm_sub_epi16(
+        _mm_slli_epi16(c, 2), _mm_add_epi16(_mm_add_epi16(l, r), _mm_add_epi16(u, d)));
+    sum_acc = _mm_add_epi32(sum_acc, _mm_madd_epi16(lap, ones));
+    sq_acc = _mm_add_epi32(sq_acc, _mm_madd_epi16(lap, lap));
+    const __m128i abs_lap = _mm_max_epi16(lap, _mm_sub_epi16(zero, lap));
+    edge_acc = _mm_sub_epi16(edge_acc, _mm_cmpgt_epi16(abs_lap, threshold));
+  }
+  int sums[4], squares[4];
+  short counts[8];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), sum_acc);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(squares), sq_acc);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(counts), edge_acc);
+  for (int i = 0; i < 4; ++i) {
+    *sum += sums[i];
+    *sum_sq += squares[i];
+  }
+  for (int i = 0; i < 8; ++i)
+    *edges += counts[i];
+#elif defined(OCRSTUDIOSDK_IMAGE_OPS_HAVE_NEON)
+  const int16x8_t threshold = vdupq_n_s16(kFrameQualityEdgeThreshold);
+  int32x4_t sum_acc = vdupq_n_s32(0), sq_acc = vdupq_n_s32(0);
+  uint16x8_t edge_acc = vdupq_n_u16(0);
+  for (; x + 8 < width; x += 8) {
+    const int16x8_t c = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(mid + x)));
+    const int16x8_t l = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(mid + x - 1)));
+    const int16x8_t r = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(mid + x + 1)));
+    const int16x8_t u = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(up + x)));
+    const int16x8_t d = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(down + x)));
+    const int16x8_t lap = vsubq_s16(
+        vshlq_n_s16(c, 2), vaddq_s16(vaddq_s16(l, r), vaddq_s16(u, d)));
+    sum_acc = vpadalq_s16(sum_acc, lap);
+    sq_acc = vmlal_s16(sq_acc, vget_low_s16(lap), vget_low_s16(lap));
+    sq_acc = vmlal_s16(sq_acc, vget_high_s16(lap), vget_high_s16(lap));
+    edge_acc = vsubq_u16(edge_acc, vcgtq_s16(vabsq_s16(lap), threshold));
+  }
+  int32_t sums[4], squares[4];
+  uint16_t counts[8];
+  vst1q_s32(sums, sum_acc);
+  vst1q_s32(squares, sq_acc);
+  vst1q_u16(counts, edge_acc);
+  for (int i = 0; i < 4; ++i) {
+    *sum += sums[i];
+    *sum_sq += squares[i];
+  }
+  for (int i = 0; i < 8; ++i)
+    *edges += counts[i];
+#endif // OCRSTUDIOSDK_IMAGE_OPS_HAVE_SSE2
+  for (; x + 1 < width; ++x) {
+    const int lap = 4 * mid[x] - mid[x - 1] - mid[x + 1] - up[x] - down[x];
+    *sum += lap;
+    *sum_sq += lap * lap;
+    if (lap > kFrameQualityEdgeThreshold || -lap > kFrameQualityEdgeThreshold)
+      ++*edges;
+  }
+}
+
+} // namespace detail
+
+
+
+/**
+ * @brief Computes the quality scores of a frame and checks them against the
+ *        thresholds. Takes well under a millisecond for camera frames, as only a
+ *        downscaled grayscale copy is analyzed.
+ * @param frame - pixels of the frame, 8-bit channels
+ * @param thresholds - quality thresholds
+ * @return Quality scores and the verdict
+ */
+inline OCRStudioSDKFrameQuality AssessFrameQuality(
+    const OCRStudioSDKPixelView&              frame,
+    const OCRStudioSDKFrameQualityThresholds& thresholds = OCRStudioSDKFrameQualityThresholds()) {
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  detail::CheckPixelView(frame);
+  const int longer_side = frame.width > frame.height ? frame.width : frame.height;
+  const int factor = (longer_side + detail::kFrameQualityMaxSide - 1) / detail::kFrameQualityMaxSide;
+  // The 2x2 average at the last sampling point must stay within the frame
+  const int width = factor > 1 && frame.width > 1 ? (frame.width - 2) / factor + 1
+                                                  : (frame.width + factor - 1) / factor;
+  const int height = factor > 1 && frame.height > 1 ? (frame.height - 2) / factor + 1
+                                                    : (frame.height + factor - 1) / factor;
+
+  std::vector<unsigned char>& gray = detail::FrameQualityScratchBuffer();
+  gray.resize(static_cast<size_t>(width) * height);
+  detail::DownscaleToGray(frame, factor, width, height, gray.data());
+
+  long long brightness_sum = 0, brightness_sq = 0, saturated = 0;
+  for (size_t i = 0; i < gray.size(); ++i) {
+    brightness_sum += gray[i];
+    brightness_sq += gray[i] * gray[i];
+    saturated += gray[i] >= 250;
+  }
+  long long lap_sum = 0, lap_sq = 0, edges = 0;
+  for (int y = 1; y + 1 < height; ++y) {
+    detail::LaplacianRowStats(&gray[(y - 1) * width], &gray[y * width],
+                              &gray[(y + 1) * width], width, &lap_sum, &lap_sq, &edges);
+  }
+
+  OCRStudioSDKFrameQuality quality;
+  const double pixels = static_cast<double>(gray.size());
+  quality.brightness = brightness_sum / pixels;
+  const double brightness_var = brightness_sq / pixels - quality.brightness * quality.brightness;
+  quality.contrast = std::sqrt(brightness_var > 0.0 ? brightness_var : 0.0);
+  quality.glare = saturated / pixels;
+  const double inner = width > 2 && height > 2 ? (width - 2.0) * (height - 2.0) : 0.0;
+  if (inner > 0.0) {
+    const double lap_mean = lap_sum / inner;
+    quality.sharpness = lap_sq / inner - lap_mean * lap_mean;
+    quality.edge_density = edges / inner;
+  } else {
+    quality.sharpness = 0.0;
+    quality.edge_density = 0.0;
+  }
+
+  quality.reason = "";
+  if (quality.brightness < thresholds.min_brightness)
+    quality.reason = "underexposed";
+  else if (quality.brightness > thresholds.max_brightness)
+    quality.reason = "overexposed";
+  else if (quality.contrast < thresholds.min_contrast ||
+           quality.edge_density < thresholds.min_edge_density)
+    quality.reason = "no_document";
+  else if (quality.glare > thresholds.max_glare)
+    quality.reason = "glare";
+  else if (quality.sharpness < thresholds.min_sharpness)
+    quality.reason = "blurry";
+  quality.accepted = quality.reason[0] == '\0';
+  quality.assessment_us = std::chrono::duration<double, std::micro>(
+      std::chrono::steady_clock::now() - start).count();
+  return quality;
+}
+
+/// Computes the quality scores of an image with 8-bit channels, see
+/// AssessFrameQuality() and PixelView()
+inline OCRStudioSDKFrameQuality AssessFrameQuality(
+    const OCRStudioSDKImage&                  frame,
+    const OCRStudioSDKFrameQualityThresholds& thresholds = OCRStudioSDKFrameQualityThresholds()) {
+  return AssessFrameQuality(PixelView(frame), thresholds);
+}
+
+/**
+ * @brief Returns the quality scores in JSON format:
+ *        {
+ *          "frame_quality": {
+ *            "accepted": (bool),
+ *            "reason": "(reason)",
+ *            "sharpness": (double),
+ *            "brightness": (double),
+ *            "contrast": (double),
+ *            "glare": (double),
+ *            "edge_density": (double),
+ *            "assessment_us": (double)
+ *          }
+ *        }
+ */
+inline std::string FrameQualityJSON(const OCRStudioSDKFrameQuality& quality) {
+  std::string json = "{\"frame_quality\": {\"accepted\": ";
+  json += quality.accepted ? "true" : "false";
+  json += ", \"reason\": ";
+  detail::AppendJSONString(json, quality.reason);
+  json += ", \"sharpness\": ";
+  detail::AppendJSONNumber(json, quality.sharpness);
+  json += ", \"brightness\": ";
+  detail::AppendJSONNumber(json, quality.brightness);
+  json += ", \"contrast\": ";
+  detail::AppendJSONNumber(json, quality.contrast);
+  json += ", \"glare\": ";
+  detail::AppendJSONNumber(json, quality.glare);
+  json += ", \"edge_density\": ";
+  detail::AppendJSONNumber(json, quality.edge_density);
+  json += ", \"assessment_us\": ";
+  detail::AppendJSONNumber(json, quality.assessment_us);
+  json += "}}";
+  return json;
+}
+
+
+
+/**
+ * @brief Session wrapper which assesses every frame before ProcessImage()
+ *        and does not pass the frames failing the quality thresholds to the
+ *        wrapped session. Rejected frames are reported to the delegate with
+ *        the message of FrameQualityJSON().
+ */
+class OCRStudioSDKQualityFilteredSession : public OCRStudioSDKSession {
+public:
+  /**
+   * @brief Main constructor
+   * @param session - session to be wrapped, the ownership is taken
+   * @param thresholds - quality thresholds
+   * @param delegate - optional delegate receiving the rejected frames
+   *        reports, must outlive the wrapper
+   */
+  explicit OCRStudioSDKQualityFilteredSession(
+      OCRStudioSDKSession*                      session,
+      const OCRStudioSDKFrameQualityThresholds& thresholds = OCRStudioSDKFrameQualityThresholds(),
+      OCRStudioSDKDelegate*                     delegate = nullptr)
+    : session_(session),
+      thresholds_(thresholds),
+      delegate_(delegate),
+      accepted_frames_(0),
+      rejected_frames_(0) {
+    last_quality_ = OCRStudioSDKFrameQuality();
+    last_quality_.reason = "";
+  }
+
+  /// Returns the scores of the last frame passed to ProcessImage() since
+  /// creation or Reset()
+  const OCRStudioSDKFrameQuality& LastQuality() const {
+    return last_quality_;
+  }
+
+  /// Returns the number of frames passed to the wrapped session since
+  /// creation or Reset()
+  int AcceptedFrames() const {
+    return accepted_frames_;
+  }
+
+  /// Returns the number of frames rejected since creation or Reset()
+  int RejectedFrames() const {
+    return rejected_frames_;
+  }
+
+  /// Returns the wrapped session
+  OCRStudioSDKSession& Session() {
+    return *session_;
+  }
+
+  virtual const char* Description() const override {
+    return session_->Description();
+  }
+
+  virtual void ProcessImage(const OCRStudioSDKImage& image) override {
+    last_quality_ = AssessFrameQuality(image, thresholds_);
+    if (!last_quality_.accepted) {
+      ++rejected_frames_;
+      if (delegate_)
+        delegate_->Callback(FrameQualityJSON(last_quality_).c_str());
+      return;
+    }
+    ++accepted_frames_;
+    session_->ProcessImage(image);
+  }
+
+  virtual void ProcessData(const char* data_str) override {
+    session_->ProcessData(data_str);
+  }
+
+  virtual const OCRStudioSDKResult& CurrentResult() const override {
+    return session_->CurrentResult();
+  }
+
+  virtual void Reset() override {
+    session_->Reset();
+    last_quality_ = OCRStudioSDKFrameQuality();
+    last_quality_.reason = "";
+    accepted_frames_ = 0;
+    rejected_frames_ = 0;
+  }
+
+  virtual void Suspend() override {
+    session_->Suspend();
+  }
+
+  virtual void Resume() override {
+    session_->Resume();
+  }
+
+private:
+  std::unique_ptr<OCRStudioSDKSession> session_;    ///< wrapped session
+  const OCRStudioSDKFrameQualityThresholds thresholds_;  ///< thresholds
+  OCRStudioSDKDelegate* delegate_;                  ///< rejection reports
+  OCRStudioSDKFrameQuality last_quality_;           ///< last assessment
+  int accepted_frames_;                             ///< passed frames
+  int rejected_frames_;                             ///< rejected frames
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_FRAME_QUALITY_H_INCLUDED
@@ -0,0 +1,160 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_hash.h
+ * @brief Fast non-cryptographic content hashing shared by the header-only
+ *        utilities
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_HASH_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_HASH_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ocrstudio {
+namespace detail {
+
+/**
+ * @brief Incremental 64-bit content hash (the XXH64 algorithm). Hashes
+ *        gigabytes per second, so content of configuration files and
+ *        images can be used as a cache key. Not suitable against adversarial
+ *        collisions.
+ */
+class ContentHasher {
+public:
+  /// Main constructor
+  explicit ContentHasher(uint64_t seed = 0)
+    : total_size_(0),
+      buffered_(0) {
+    acc_[0] = seed + kPrime1 + kPrime2;
+    acc_[1] = seed + kPrime2;
+    acc_[2] = seed;
+    acc_[3] = seed - kPrime1;
+    seed_ = seed;
+  }
+
+  /**
+   * @brief Appends data to the hashed content
+   * @param data - pointer to the data
+   * @param size - size of the data in bytes
+   */
+  void Update(const void* data, size_t size) {
+    const unsigned char* pos = static_cast<const unsigned char*>(data);
+    total_size_ += size;
+    if (buffered_ + size < kStripeSize) {
+      if (size)
+        std::memcpy(buffer_ + buffered_, pos, size);
+      buffered_ += size;
+      return;
+    }
+    if (buffered_) {
+      const size_t fill = kStripeSize - buffered_;
+      std::memcpy(buffer_ + buffered_, pos, fill);
+      ConsumeStripe(buffer_);
+      pos += fill;
+      size -= fill;
+      buffered_ = 0;
+    }
+    for (; size >= kStripeSize; pos += kStripeSize, size -= kStripeSize)
+      ConsumeStripe(pos);
+    if (size)
+      std::memcpy(buffer_, pos, size);
+    buffered_ = size;
+  }
+
+  /// Appends a value to the hashed content
+  template <typename T>
+  void UpdateValue(const T& value) {
+    Update(&value, sizeof(value));
+  }
+
+  /// Returns the hash of the content appended so far
+  uint64_t Digest() const {
+    uint64_t hash;
+    if (total_size_ >= kStripeSize) {
+      hash = Rotl(acc_[0], 1) + Rotl(acc_[1], 7) + Rotl(acc_[2], 12) + Rotl(acc_[3], 18);
+      for (int i = 0; i < 4; ++i)
+        hash = (hash ^ Round(0, acc_[i])) * kPrime1 + kPrime4;
+    } else {
+      hash = seed_ + kPrime5;
+    }
+    hash += static_cast<uint64_t>(total_size_);
+
+    const unsigned char* pos = buffer_;
+    const unsigned char* end = buffer_ + buffered_;
+    for (; pos + 8 <= end; pos += 8)
+      hash = Rotl(hash ^ Round(0, Read64(pos)), 27) * kPrime1 + kPrime4;
+    if (pos + 4 <= end) {
+      hash = Rotl(hash ^ (Read32(pos) * kPrime1), 23) * kPrime2 + kPrime3;
+      pos += 4;
+    }
+    for (; pos < end; ++pos)
+      hash = Rotl(hash ^ (*pos * kPrime5), 11) * kPrime1;
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+  }
+
+private:
+  static const size_t kStripeSize = 32;
+  static const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+  static const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+  static const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+  static const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+  static const uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+  static uint64_t Rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+  }
+
+  static uint64_t Round(uint64_t acc, uint64_t input) {
+    return Rotl(acc + input * kPrime2, 31) * kPrime1;
+  }
+
+  /// Little-endian loads, as in the reference implementation
+  static uint64_t Read64(const unsigned char* pos) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i)
+      value = (value << 8) | pos[i];
+    return value;
+  }
+
+  static uint64_t Read32(const unsigned char* pos) {
+    return static_cast<uint64_t>(pos[0]) | (static_cast<uint64_t>(pos[1]) << 8) |
+           (static_cast<uint64_t>(pos[2]) << 16) | (static_cast<uint64_t>(pos[3]) << 24);
+  }
+
+  void ConsumeStripe(const unsigned char* stripe) {
+    for (int i = 0; i < 4; ++i)
+      acc_[i] = Round(acc_[i], Read64(stripe + 8 * i));
+  }
+
+private:
+  uint64_t acc_[4];                       ///< stripe accumulators
+  uint64_t seed_;                         ///< hash seed
+  unsigned long long total_size_;         ///< hashed content size
+  unsigned char buffer_[kStripeSize];     ///< incomplete stripe
+  size_t buffered_;                       ///< bytes in the incomplete stripe
+};
+
+/// Returns the 64-bit content hash of a buffer, see ContentHasher
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0) {
+  ContentHasher hasher(seed);
+  hasher.Update(data, size);
+  return hasher.Digest();
+}
+
+} // namespace detail
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_HASH_H_INCLUDED
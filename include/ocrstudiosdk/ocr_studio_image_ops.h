@@ -0,0 +1,824 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_image_ops.h
+ * @brief Allocation-free scaling, cropping and rotation of 8-bit images into
+ *        existing destination buffers (header-only, built on top of the
+ *        public image interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_IMAGE_OPS_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_IMAGE_OPS_H_INCLUDED
+
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+# define OCRSTUDIOSDK_IMAGE_OPS_HAVE_SSE2 1
+# include <emmintrin.h>
+#endif // __SSE2__
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define OCRSTUDIOSDK_IMAGE_OPS_HAVE_NEON 1
+# include <arm_neon.h>
+#endif // __ARM_NEON
+
+#include <ocrstudiosdk/ocr_studio_image.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Non-owning view of 8-bit interleaved pixels, either of an image
+ *        (see PixelView()) or of a caller-provided buffer
+ */
+struct OCRStudioSDKPixelView {
+  unsigned char* data;  ///< Pointer to the first pixel
+  int width;            ///< Width in pixels
+  int height;           ///< Height in pixels
+  int bytes_per_line;   ///< Size of a row in bytes, including alignment
+  int channels;         ///< Number of 8-bit channels per pixel
+};
+
+namespace detail {
+
+/// Checks the shape of a pixel view. The channel depth cannot be checked:
+/// rows of 16-bit pixels look like padded rows of 8-bit ones.
+inline void CheckPixelView(const OCRStudioSDKPixelView& view) {
+  if (!view.data || view.width <= 0 || view.height <= 0 || view.channels <= 0 ||
+      view.bytes_per_line < view.width * view.channels) {
+    throw OCRStudioSDKException(
+        "InvalidArgumentException", "Invalid pixel buffer, 8-bit pixels expected");
+  }
+}
+
+inline void CheckSameChannels(const OCRStudioSDKPixelView& src,
+                              const OCRStudioSDKPixelView& dst) {
+  if (src.channels != dst.channels) {
+    throw OCRStudioSDKException(
+        "InvalidArgumentException",
+        "Source and destination have different numbers of channels");
+  }
+}
+
+/// Rejects quadrangles with NaN or infinite coordinates
+inline void CheckQuad(const double* quad) {
+  for (int i = 0; i < 8; ++i) {
+    if (!std::isfinite(quad[i])) {
+      throw OCRStudioSDKException(
+          "InvalidArgumentException", "Quad coordinates must be finite");
+    }
+  }
+}
+
+/// Scratch buffers reused by the calls made on the same thread
+struct ImageOpsScratch {
+  std::vector<int> x_index0;   ///< left source pixel of each column
+  std::vector<int> x_index1;   ///< right source pixel of each column
+  std::vector<int> x_weight;   ///< weight of the right pixel, 0..128
+  std::vector<unsigned char> rows;  ///< two horizontally resampled rows
+};
+
+inline ImageOpsScratch& ImageOpsScratchBuffers() {
+  static thread_local ImageOpsScratch scratch;
+  return scratch;
+}
+
+/// Computes the bilinear tap mapping a destination pixel center to the source
+inline void ComputeResampleTap(int src_size, int dst_size, int i,
+                               int* index0, int* index1, int* weight) {
+  double position = (i + 0.5) * src_size / dst_size - 0.5;
+  if (position < 0.0)
+    position = 0.0;
+  if (position > src_size - 1)
+    position = src_size - 1;
+  const int i0 = static_cast<int>(position);
+  *index0 = i0;
+  *index1 = i0 + 1 < src_size ? i0 + 1 : i0;
+  *weight = static_cast<int>((position - i0) * 128.0 + 0.5);
+}
+
+/// Resamples a row horizontally, C is the number of channels or 0 for any
+template <int C>
+inline void ResampleRow(const unsigned char* src, int channels,
+                        const int* index0, const int* index1, const int* weight,
+                        int dst_width, unsigned char* dst) {
+  const int c = C > 0 ? C : channels;
+  for (int x = 0; x < dst_width; ++x, dst += c) {
+    const unsigned char* p0 = src + index0[x] * c;
+    const unsigned char* p1 = src + index1[x] * c;
+    const int w1 = weight[x];
+    const int w0 = 128 - w1;
+    for (int k = 0; k < c; ++k)
+      dst[k] = static_cast<unsigned char>((p0[k] * w0 + p1[k] * w1 + 64) >> 7);
+  }
+}
+
+inline void ResampleRowAnyChannels(const unsigned char* src, int channels,
+                                   const int* index0, const int* index1,
+                                   const int* weight, int dst_width,
+                                   unsigned char* dst) {
+  switch (channels) {
+  case 1: ResampleRow<1>(src, channels, index0, index1, weight, dst_width, dst); break;
+  case 3: ResampleRow<3>(src, channels, index0, index1, weight, dst_width, dst); break;
+  case 4: ResampleRow<4>(src, channels, index0, index1, weight, dst_width, dst); break;
+  default: ResampleRow<0>(src, channels, index0, index1, weight, dst_width, dst);
+  }
+}
+
+/// Blends two rows as (row0 * (128 - weight) + row1 * weight + 64) >> 7;
+/// the sums fit into 16 bits, so all code paths produce identical output
+inline void BlendRows(const unsigned char* row0, const unsigned char* row1,
+                      int weight, int size, unsigned char* dst) {
+  if (weight == 0) {
+    std::memcpy(dst, row0, static_cast<size_t>(size));
+    return;
+  }
+  int i = 0;
+#if defined(OCRSTUDIOSDK_IMAGE_OPS_HAVE_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i w0 = _mm_set1_epi16(static_cast<short>(128 - weight));
+  const __m128i w1 = _mm_set1_epi16(static_cast<short>(weight));
+  const __m128i half = _mm_set1_epi16(64);
+  for (; i + 16 <= size; i += 16) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), w0),
+                               _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), w1));
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), w0),
+                               _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), w1));
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, half), 7);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, half), 7);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+  }
+#elif defined(OCRSTUDIOSDK_IMAGE_OPS_HAVE_NEON)
+  const uint8x8_t w0 = vdup_n_u8(static_cast<uint8_t>(128 - weight));
+  const uint8x8_t w1 = vdup_n_u8(static_cast<uint8_t>(weight));
+  for (; i + 16 <= size; i += 16) {
+    const uint8x16_t a = vld1q_u8(row0 + i);
+    const uint8x16_t b = vld1q_u8(row1 + i);
+    const uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(a), w0), vget_low_u8(b), w1);
+    const uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(a), w0), vget_high_u8(b), w1);
+    vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(lo, 7), vrshrn_n_u16(hi, 7)));
+  }
+#endif // OCRSTUDIOSDK_IMAGE_OPS_HAVE_SSE2
+  for (; i < size; ++i) {
+    dst[i] = static_cast<unsigned char>(
+        (row0[i] * (128 - weight) + row1[i] * weight + 64) >> 7);
+  }
+}
+
+/// Rotates clockwise by 90 degrees 1, 2 or 3 times, traversing the
+/// destination in tiles so that the source columns stay in cache
+template <int C>
+inline void RotatePixels(const OCRStudioSDKPixelView& src, int rotations,
+                         const OCRStudioSDKPixelView& dst) {
+  const int c = C > 0 ? C : src.channels;
+  const int tile = 32;
+  // Source pointer and step for the destination pixel (x, y):
+  //   1: src(y, height - 1 - x), 2: src(width - 1 - x, height - 1 - y),
+  //   3: src(width - 1 - y, x)
+  const ptrdiff_t bpl = src.bytes_per_line;
+  const ptrdiff_t step = rotations == 1 ? -bpl : (rotations == 2 ? -c : bpl);
+  for (int tile_y = 0; tile_y < dst.height; tile_y += tile) {
+    const int y_end = tile_y + tile < dst.height ? tile_y + tile : dst.height;
+    for (int tile_x = 0; tile_x < dst.width; tile_x += tile) {
+      const int x_end = tile_x + tile < dst.width ? tile_x + tile : dst.width;
+      for (int y = tile_y; y < y_end; ++y) {
+        const unsigned char* in;
+        if (rotations == 1)
+          in = src.data + (src.height - 1 - tile_x) * bpl + y * c;
+        else if (rotations == 2)
+          in = src.data + (src.height - 1 - y) * bpl + (src.width - 1 - tile_x) * c;
+        else
+          in = src.data + tile_x * bpl + (src.width - 1 - y) * c;
+        unsigned char* out = dst.data + y * dst.bytes_per_line + tile_x * c;
+        for (int x = tile_x; x < x_end; ++x, in += step, out += c) {
+          for (int k = 0; k < c; ++k)
+            out[k] = in[k];
+        }
+      }
+    }
+  }
+}
+
+/// Projective mapping of the unit square onto a quadrilateral:
+///   x = (a * u + b * v + c) / (g * u + h * v + 1)
+///   y = (d * u + e * v + f) / (g * u + h * v + 1)
+struct QuadMapping {
+  double a, b, c, d, e, f, g, h;
+};
+
+/// Computes the mapping of the corners (0, 0), (1, 0), (1, 1), (0, 1) onto
+/// the quad points (x1, y1) ... (x4, y4)
+inline QuadMapping ComputeQuadMapping(const double* quad) {
+  const double x0 = quad[0], y0 = quad[1], x1 = quad[2], y1 = quad[3];
+  const double x2 = quad[4], y2 = quad[5], x3 = quad[6], y3 = quad[7];
+  QuadMapping m;
+  m.g = 0.0;
+  m.h = 0.0;
+  const double sx = x0 - x1 + x2 - x3;
+  const double sy = y0 - y1 + y2 - y3;
+  const double dx1 = x1 - x2, dx2 = x3 - x2, dy1 = y1 - y2, dy2 = y3 - y2;
+  const double den = dx1 * dy2 - dx2 * dy1;
+  if ((sx != 0.0 || sy != 0.0) && den != 0.0) {
+    m.g = (sx * dy2 - dx2 * sy) / den;
+    m.h = (dx1 * sy - sx * dy1) / den;
+  }
+  m.a = x1 - x0 + m.g * x1;
+  m.b = x3 - x0 + m.h * x3;
+  m.c = x0;
+  m.d = y1 - y0 + m.g * y1;
+  m.e = y3 - y0 + m.h * y3;
+  m.f = y0;
+  return m;
+}
+
+/// Warps the destination region [x_begin, x_end) x [y_begin, y_end) with
+/// bilinear sampling; source coordinates are clamped to the image
+template <int C>
+inline void WarpQuadRegion(const OCRStudioSDKPixelView& src, const QuadMapping& m,
+                           const OCRStudioSDKPixelView& dst, int x_begin, int x_end,
+                           int y_begin, int y_end) {
+  const int c = C > 0 ? C : src.channels;
+  const double du = 1.0 / dst.width;
+  const double max_x = src.width - 1;
+  const double max_y = src.height - 1;
+  for (int y = y_begin; y < y_end; ++y) {
+    const double v = (y + 0.5) / dst.height;
+    const double u = (x_begin + 0.5) * du;
+    double nx = m.a * u + m.b * v + m.c;
+    double ny = m.d * u + m.e * v + m.f;
+    double nw = m.g * u + m.h * v + 1.0;
+    unsigned char* out = dst.data + y * dst.bytes_per_line + x_begin * c;
+    for (int x = x_begin; x < x_end; ++x, out += c) {
+      // Pixel (i, j) covers [i, i + 1) x [j, j + 1) in quad coordinates
+      double sx = nx / nw - 0.5;
+      double sy = ny / nw - 0.5;
+      nx += m.a * du;
+      ny += m.d * du;
+      nw += m.g * du;
+      // Written so that NaN, from a degenerate quad, is clamped to 0
+      sx = sx >= 0.0 ? (sx > max_x ? max_x : sx) : 0.0;
+      sy = sy >= 0.0 ? (sy > max_y ? max_y : sy) : 0.0;
+      const int x0 = static_cast<int>(sx);
+      const int y0 = static_cast<int>(sy);
+      const int fx = static_cast<int>((sx - x0) * 128.0 + 0.5);
+      const int fy = static_cast<int>((sy - y0) * 128.0 + 0.5);
+      const unsigned char* p00 = src.data + y0 * src.bytes_per_line + x0 * c;
+      const unsigned char* p01 = x0 < src.width - 1 ? p00 + c : p00;
+      const unsigned char* p10 = y0 < src.height - 1 ? p00 + src.bytes_per_line : p00;
+      const unsigned char* p11 = x0 < src.width - 1 ? p10 + c : p10;
+      for (int k = 0; k < c; ++k) {
+        const int top = p00[k] * (128 - fx) + p01[k] * fx;
+        const int bottom = p10[k] * (128 - fx) + p11[k] * fx;
+        out[k] = static_cast<unsigned char>((top * (128 - fy) + bottom * fy + 8192) >> 14);
+      }
+    }
+  }
+}
+
+inline void WarpQuadRegionAnyChannels(
+    const OCRStudioSDKPixelView& src, const QuadMapping& m,
+    const OCRStudioSDKPixelView& dst, int x_begin, int x_end, int y_begin, int y_end) {
+  switch (src.channels) {
+  case 1: WarpQuadRegion<1>(src, m, dst, x_begin, x_end, y_begin, y_end); break;
+  case 3: WarpQuadRegion<3>(src, m, dst, x_begin, x_end, y_begin, y_end); break;
+  case 4: WarpQuadRegion<4>(src, m, dst, x_begin, x_end, y_begin, y_end); break;
+  default: WarpQuadRegion<0>(src, m, dst, x_begin, x_end, y_begin, y_end);
+  }
+}
+
+/// Size of the destination tiles warped at once. Neighbouring destination
+/// pixels map to neighbouring source pixels, so a tile reads a compact
+/// source region instead of a long line across the source image.
+const int kWarpTileSize = 64;
+
+inline int WarpTilesCount(const OCRStudioSDKPixelView& dst) {
+  return ((dst.width + kWarpTileSize - 1) / kWarpTileSize) *
+         ((dst.height + kWarpTileSize - 1) / kWarpTileSize);
+}
+
+/// Warps the tile with the given index, tiles are numbered row by row
+inline void WarpQuadTile(const OCRStudioSDKPixelView& src, const QuadMapping& m,
+                         const OCRStudioSDKPixelView& dst, int tile) {
+  const int tiles_per_row = (dst.width + kWarpTileSize - 1) / kWarpTileSize;
+  const int x_begin = (tile % tiles_per_row) * kWarpTileSize;
+  const int y_begin = (tile / tiles_per_row) * kWarpTileSize;
+  const int x_end = x_begin + kWarpTileSize < dst.width ? x_begin + kWarpTileSize : dst.width;
+  const int y_end = y_begin + kWarpTileSize < dst.height ? y_begin + kWarpTileSize : dst.height;
+  WarpQuadRegionAnyChannels(src, m, dst, x_begin, x_end, y_begin, y_end);
+}
+
+/// Returns the approximate rectified size of a quad: the longer of the
+/// opposite sides
+inline void EstimateQuadSize(const double* quad, int* width, int* height) {
+  const double top = std::hypot(quad[2] - quad[0], quad[3] - quad[1]);
+  const double bottom = std::hypot(quad[4] - quad[6], quad[5] - quad[7]);
+  const double left = std::hypot(quad[6] - quad[0], quad[7] - quad[1]);
+  const double right = std::hypot(quad[4] - quad[2], quad[5] - quad[3]);
+  const double max_size = INT_MAX / 4;
+  const double w_size = (top > bottom ? top : bottom) + 0.5;
+  const double h_size = (left > right ? left : right) + 0.5;
+  const int w = static_cast<int>(w_size < max_size ? w_size : max_size);
+  const int h = static_cast<int>(h_size < max_size ? h_size : max_size);
+  *width = w > 0 ? w : 1;
+  *height = h > 0 ? h : 1;
+}
+
+} // namespace detail
+
+
+
+/**
+ * @brief Fixed set of threads running a job together with the calling
+ *        thread, used by CropByQuadsInto() so that the threads are not
+ *        created on every call. One job runs at a time: if the pool is busy
+ *        with a job of another thread, the new job runs on the calling
+ *        thread alone instead of waiting.
+ */
+class OCRStudioSDKWorkerPool {
+public:
+  /**
+   * @brief Main constructor, starts the threads
+   * @param num_threads - number of threads including the calling one (0 for
+   *        the number of hardware threads)
+   */
+  explicit OCRStudioSDKWorkerPool(int num_threads = 0)
+    : job_(nullptr),
+      generation_(0),
+      participants_(0),
+      active_(0),
+      stopping_(false) {
+    if (num_threads <= 0)
+      num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    try {
+      for (int i = 1; i < num_threads; ++i)
+        threads_.push_back(std::thread(&OCRStudioSDKWorkerPool::RunWorker, this, i - 1));
+    } catch (...) {
+      Stop();
+      throw;
+    }
+  }
+
+  /// Non-copyable
+  OCRStudioSDKWorkerPool(const OCRStudioSDKWorkerPool&) = delete;
+  OCRStudioSDKWorkerPool& operator =(const OCRStudioSDKWorkerPool&) = delete;
+
+  /// Destructor, stops the threads
+  ~OCRStudioSDKWorkerPool() {
+    Stop();
+  }
+
+  /// Returns the process-wide pool with a thread per hardware thread
+  static OCRStudioSDKWorkerPool& Default() {
+    // Intentionally leaked, so that it may be used during process shutdown
+    static OCRStudioSDKWorkerPool* pool = new OCRStudioSDKWorkerPool();
+    return *pool;
+  }
+
+  /// Returns the number of threads including the calling one
+  int ThreadsCount() const {
+    return static_cast<int>(threads_.size()) + 1;
+  }
+
+  /**
+   * @brief Runs a job on the calling thread and on pool threads, returns
+   *        when all of them have finished it. The job splits the work itself,
+   *        e.g. by taking work items from an atomic counter. Exceptions of
+   *        the job on pool threads are ignored, on the calling thread they
+   *        are rethrown once the pool threads have finished. A job started
+   *        from within a job of any pool runs on the calling thread only.
+   * @param job - the job
+   * @param num_threads - maximum number of threads including the calling one
+   *        (0 for all threads of the pool)
+   */
+  void Run(const std::function<void()>& job, int num_threads = 0) {
+    bool& inside_job = InsideJob();
+    if (inside_job) {
+      job();
+      return;
+    }
+    std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+    int participants = static_cast<int>(threads_.size());
+    if (num_threads > 0 && num_threads - 1 < participants)
+      participants = num_threads - 1;
+    if (!run_lock.owns_lock() || participants <= 0) {
+      inside_job = true;
+      try {
+        job();
+      } catch (...) {
+        inside_job = false;
+        throw;
+      }
+      inside_job = false;
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &job;
+      participants_ = participants;
+      active_ = participants;
+      ++generation_;
+    }
+    start_cv_.notify_all();
+
+    std::exception_ptr error;
+    inside_job = true;
+    try {
+      job();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    inside_job = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_cv_.wait(lock, [this]() { return active_ == 0; });
+      job_ = nullptr;
+    }
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+private:
+  /// Returns the flag of the calling thread set while it runs a job of a
+  /// pool. Nested jobs run inline: the thread may already hold run_mutex_,
+  /// and a pool thread must not wait for its own pool.
+  static bool& InsideJob() {
+    static thread_local bool inside_job = false;
+    return inside_job;
+  }
+
+  /// Thread loop: runs each new job if the thread index is among its
+  /// participants
+  void RunWorker(int index) {
+    // Pool threads only ever run jobs
+    InsideJob() = true;
+    std::unique_lock<std::mutex> lock(mutex_);
+    unsigned long long seen_generation = 0;
+    for (;;) {
+      start_cv_.wait(lock, [&]() { return stopping_ || generation_ != seen_generation; });
+      if (stopping_)
+        break;
+      seen_generation = generation_;
+      if (index >= participants_)
+        continue;
+      const std::function<void()>* job = job_;
+      lock.unlock();
+      try {
+        (*job)();
+      } catch (...) {
+        // Exceptions of the job must not stop the thread
+      }
+      lock.lock();
+      if (--active_ == 0)
+        done_cv_.notify_all();
+    }
+  }
+
+  /// Stops and joins the started threads
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    start_cv_.notify_all();
+    for (size_t i = 0; i < threads_.size(); ++i)
+      threads_[i].join();
+  }
+
+private:
+  std::vector<std::thread> threads_;         ///< pool threads
+  std::mutex run_mutex_;                     ///< held while a job runs
+
+  std::mutex mutex_;                         ///< guards the fields below
+  std::condition_variable start_cv_;         ///< signals a new job or stop
+  std::condition_variable done_cv_;          ///< signals the end of a job
+  const std::function<void()>* job_;         ///< current job
+  unsigned long long generation_;            ///< number of jobs started
+  int participants_;                         ///< pool threads of the job
+  int active_;                               ///< pool threads still running it
+  bool stopping_;                            ///< destructor was called
+};
+
+
+
+/**
+ * @brief Returns a view of the pixels of an image with 8-bit channels.
+ *        Writing through the view modifies the image, and the pixels shared
+ *        with it if the image is a shallow copy.
+ *
+ *        The image must have 8-bit channels. Images with 16-bit channels
+ *        (OCRStudioSDKImage::CreateFromPixelBuffer() with 2 bytes per
+ *        channel) cannot be told apart through the image interface; their
+ *        views are accepted and their pixels are misread.
+ * @param image - the image, with 8-bit channels
+ * @return Pixel view, valid while the image is alive and not modified
+ */
+inline OCRStudioSDKPixelView PixelView(const OCRStudioSDKImage& image) {
+  OCRStudioSDKPixelView view;
+  view.data = static_cast<unsigned char*>(image.UnsafeBufferPtr());
+  view.width = image.Width();
+  view.height = image.Height();
+  view.bytes_per_line = image.BytesPerLine();
+  view.channels = image.Channels();
+  detail::CheckPixelView(view);
+  return view;
+}
+
+/**
+ * @brief Returns the image held by the pointer if it has the requested
+ *        shape, otherwise replaces it with a new image of that shape. Used to
+ *        keep a destination image across calls, so its pixel buffer is only
+ *        allocated when the shape changes. A new image is created from a
+ *        temporary zeroed buffer, which the engine copies.
+ * @param image - destination image holder, may be empty
+ * @param width - width of the image in pixels
+ * @param height - height of the image in pixels
+ * @param channels - number of channels per pixel
+ * @return Reference to the image held by the pointer
+ */
+inline OCRStudioSDKImage& ReuseOrCreateImage(
+    std::unique_ptr<OCRStudioSDKImage>& image, int width, int height, int channels) {
+  if (image && image->OwnsPixelData() && image->Width() == width &&
+      image->Height() == height && image->Channels() == channels) {
+    return *image;
+  }
+  if (width <= 0 || height <= 0 || channels <= 0 || width > INT_MAX / channels / height)
+    throw OCRStudioSDKException("InvalidArgumentException", "Invalid image size");
+  const int bytes_per_line = width * channels;
+  std::vector<unsigned char> pixels(static_cast<size_t>(bytes_per_line) * height);
+  image.reset(OCRStudioSDKImage::CreateFromBuffer(
+      pixels.data(), static_cast<int>(pixels.size()), width, height, bytes_per_line, channels));
+  return *image;
+}
+
+/**
+ * @brief Scales the source pixels to the size of the destination with
+ *        bilinear interpolation
+ * @param src - source pixels
+ * @param dst - destination pixels with the same number of channels, must
+ *        not overlap the source
+ */
+inline void ScaleInto(const OCRStudioSDKPixelView& src, const OCRStudioSDKPixelView& dst) {
+  detail::CheckPixelView(src);
+  detail::CheckPixelView(dst);
+  detail::CheckSameChannels(src, dst);
+  const int c = src.channels;
+  const int row_size = dst.width * c;
+  if (src.width == dst.width && src.height == dst.height) {
+    for (int y = 0; y < dst.height; ++y) {
+      std::memcpy(dst.data + y * dst.bytes_per_line,
+                  src.data + y * src.bytes_per_line, static_cast<size_t>(row_size));
+    }
+    return;
+  }
+
+  detail::ImageOpsScratch& scratch = detail::ImageOpsScratchBuffers();
+  scratch.x_index0.resize(static_cast<size_t>(dst.width));
+  scratch.x_index1.resize(static_cast<size_t>(dst.width));
+  scratch.x_weight.resize(static_cast<size_t>(dst.width));
+  scratch.rows.resize(static_cast<size_t>(row_size) * 2);
+  for (int x = 0; x < dst.width; ++x) {
+    detail::ComputeResampleTap(src.width, dst.width, x, &scratch.x_index0[x],
+                               &scratch.x_index1[x], &scratch.x_weight[x]);
+  }
+
+  // Horizontally resampled source rows, reused while the output advances
+  unsigned char* rows[2] = {scratch.rows.data(), scratch.rows.data() + row_size};
+  int row_tags[2] = {-1, -1};
+  for (int y = 0; y < dst.height; ++y) {
+    int y0, y1, weight;
+    detail::ComputeResampleTap(src.height, dst.height, y, &y0, &y1, &weight);
+    const int needed[2] = {y0, y1};
+    for (int k = 0; k < 2; ++k) {
+      if (row_tags[0] == needed[k] || row_tags[1] == needed[k])
+        continue;
+      const int slot = (row_tags[0] == y0 || row_tags[0] == y1) ? 1 : 0;
+      detail::ResampleRowAnyChannels(
+          src.data + needed[k] * src.bytes_per_line, c, scratch.x_index0.data(),
+          scratch.x_index1.data(), scratch.x_weight.data(), dst.width, rows[slot]);
+      row_tags[slot] = needed[k];
+    }
+    detail::BlendRows(row_tags[0] == y0 ? rows[0] : rows[1],
+                      row_tags[0] == y1 ? rows[0] : rows[1], weight, row_size,
+                      dst.data + y * dst.bytes_per_line);
+  }
+}
+
+/**
+ * @brief Copies a rectangular region of the source into the destination
+ * @param src - source pixels
+ * @param x - horizontal coordinate of the top-left corner
+ * @param y - vertical coordinate of the top-left corner
+ * @param dst - destination pixels, its size is the size of the region
+ */
+inline void CropByRectInto(const OCRStudioSDKPixelView& src, int x, int y,
+                           const OCRStudioSDKPixelView& dst) {
+  detail::CheckPixelView(src);
+  detail::CheckPixelView(dst);
+  detail::CheckSameChannels(src, dst);
+  if (x < 0 || y < 0 || x + dst.width > src.width || y + dst.height > src.height) {
+    throw OCRStudioSDKException(
+        "InvalidArgumentException", "Crop rectangle is out of the image bounds");
+  }
+  const size_t row_size = static_cast<size_t>(dst.width) * dst.channels;
+  for (int row = 0; row < dst.height; ++row) {
+    std::memcpy(dst.data + row * dst.bytes_per_line,
+                src.data + (y + row) * src.bytes_per_line + x * src.channels, row_size);
+  }
+}
+
+/**
+ * @brief Copies the source rotated clockwise by 90 degrees into the
+ *        destination
+ * @param src - source pixels
+ * @param num_rotations - the number of times the rotation is performed
+ * @param dst - destination pixels, with width and height swapped for an odd
+ *        number of rotations; must not overlap the source
+ */
+inline void RotateByNinetyInto(const OCRStudioSDKPixelView& src, int num_rotations,
+                               const OCRStudioSDKPixelView& dst) {
+  detail::CheckPixelView(src);
+  detail::CheckPixelView(dst);
+  detail::CheckSameChannels(src, dst);
+  const int rotations = ((num_rotations % 4) + 4) % 4;
+  const bool swapped = (rotations % 2) == 1;
+  if (dst.width != (swapped ? src.height : src.width) ||
+      dst.height != (swapped ? src.width : src.height)) {
+    throw OCRStudioSDKException(
+        "InvalidArgumentException", "Destination size does not match the rotated image");
+  }
+  if (rotations == 0) {
+    CropByRectInto(src, 0, 0, dst);
+    return;
+  }
+  switch (src.channels) {
+  case 1: detail::RotatePixels<1>(src, rotations, dst); break;
+  case 3: detail::RotatePixels<3>(src, rotations, dst); break;
+  case 4: detail::RotatePixels<4>(src, rotations, dst); break;
+  default: detail::RotatePixels<0>(src, rotations, dst);
+  }
+}
+
+/**
+ * @brief Copies a quadrilateral of the source, rectified to the size of the
+ *        destination with bilinear interpolation; points outside of the
+ *        source are clamped to its border
+ * @param src - source pixels
+ * @param quad - quadrangle coordinates x1, y1, x2, y2, x3, y3, x4, y4 in the
+ *        order of OCRStudioSDKImage::CropByQuad() (top-left, top-right,
+ *        bottom-right, bottom-left corners of the result)
+ * @param dst - destination pixels with the same number of channels, must
+ *        not overlap the source
+ */
+inline void CropByQuadInto(const OCRStudioSDKPixelView& src, const double* quad,
+                           const OCRStudioSDKPixelView& dst) {
+  detail::CheckPixelView(src);
+  detail::CheckPixelView(dst);
+  detail::CheckSameChannels(src, dst);
+  if (!quad)
+    throw OCRStudioSDKException("InvalidArgumentException", "Quad is null");
+  detail::CheckQuad(quad);
+  const detail::QuadMapping mapping = detail::ComputeQuadMapping(quad);
+  const int tiles_count = detail::WarpTilesCount(dst);
+  for (int tile = 0; tile < tiles_count; ++tile)
+    detail::WarpQuadTile(src, mapping, dst, tile);
+}
+
+/**
+ * @brief Copies several quadrilaterals of the source into their destinations
+ *        in one call, see CropByQuadInto(). The destinations are split into
+ *        tiles which are warped in parallel on the threads of a worker pool,
+ *        so both many small quads and a few large ones are spread over the
+ *        threads.
+ * @param src - source pixels
+ * @param quads - quads_count quadrangles, 8 coordinates each
+ * @param quads_count - number of quadrangles
+ * @param dsts - quads_count destinations, must not overlap the source or
+ *        each other
+ * @param num_threads - maximum number of threads including the calling one
+ *        (0 for all threads of the pool)
+ * @param pool - worker pool (null for OCRStudioSDKWorkerPool::Default())
+ */
+inline void CropByQuadsInto(const OCRStudioSDKPixelView& src, const double* quads,
+                            int quads_count, const OCRStudioSDKPixelView* dsts,
+                            int num_threads = 0, OCRStudioSDKWorkerPool* pool = nullptr) {
+  detail::CheckPixelView(src);
+  if (quads_count <= 0)
+    return;
+  if (!quads || !dsts)
+    throw OCRStudioSDKException("InvalidArgumentException", "Quads or destinations are null");
+  std::vector<detail::QuadMapping> mappings(static_cast<size_t>(quads_count));
+  // tile_offsets[i] is the number of tiles of the quads before i
+  std::vector<int> tile_offsets(static_cast<size_t>(quads_count) + 1, 0);
+  for (int i = 0; i < quads_count; ++i) {
+    detail::CheckPixelView(dsts[i]);
+    detail::CheckSameChannels(src, dsts[i]);
+    detail::CheckQuad(quads + 8 * i);
+    mappings[i] = detail::ComputeQuadMapping(quads + 8 * i);
+    tile_offsets[i + 1] = tile_offsets[i] + detail::WarpTilesCount(dsts[i]);
+  }
+  const int tiles_count = tile_offsets[quads_count];
+
+  std::atomic<int> next_tile(0);
+  const std::function<void()> worker = [&]() {
+    int quad = 0;
+    for (int tile = next_tile.fetch_add(1); tile < tiles_count;
+         tile = next_tile.fetch_add(1)) {
+      // Tiles are handed out in increasing order
+      while (tile >= tile_offsets[quad + 1])
+        ++quad;
+      detail::WarpQuadTile(src, mappings[quad], dsts[quad], tile - tile_offsets[quad]);
+    }
+  };
+
+  if (!pool)
+    pool = &OCRStudioSDKWorkerPool::Default();
+  if (num_threads <= 0 || num_threads > tiles_count)
+    num_threads = tiles_count;
+  pool->Run(worker, num_threads);
+}
+
+/// Scales an 8-bit image to the size of the destination image, see ScaleInto()
+/// and PixelView()
+inline void ScaleInto(const OCRStudioSDKImage& src, OCRStudioSDKImage& dst) {
+  ScaleInto(PixelView(src), PixelView(dst));
+}
+
+/// Copies a region of the same size as the destination image, see
+/// CropByRectInto(); both images must have 8-bit channels, see PixelView()
+inline void CropByRectInto(const OCRStudioSDKImage& src, int x, int y,
+                           OCRStudioSDKImage& dst) {
+  CropByRectInto(PixelView(src), x, y, PixelView(dst));
+}
+
+/// Rotates an 8-bit image into the destination image, see RotateByNinetyInto()
+/// and PixelView()
+inline void RotateByNinetyInto(const OCRStudioSDKImage& src, int num_rotations,
+                               OCRStudioSDKImage& dst) {
+  RotateByNinetyInto(PixelView(src), num_rotations, PixelView(dst));
+}
+
+/// Crops a quadrilateral of an 8-bit image into the destination image, see
+/// CropByQuadInto() and PixelView()
+inline void CropByQuadInto(const OCRStudioSDKImage& src, const double* quad,
+                           OCRStudioSDKImage& dst) {
+  CropByQuadInto(PixelView(src), quad, PixelView(dst));
+}
+
+/**
+ * @brief Crops several quadrilaterals of an image into images, see
+ *        CropByQuadsInto(). The images in the vector are reused when they
+ *        already have the requested size, see ReuseOrCreateImage().
+ * @param src - source image, with 8-bit channels (see PixelView())
+ * @param quads - quads_count quadrangles, 8 coordinates each
+ * @param sizes - quads_count pairs of width and height, a non-positive value
+ *        or null for the size approximated from the quadrangle
+ * @param quads_count - number of quadrangles
+ * @param dsts - destination images, resized to quads_count
+ * @param num_threads - maximum number of threads including the calling one
+ *        (0 for all threads of the pool)
+ * @param pool - worker pool (null for OCRStudioSDKWorkerPool::Default())
+ */
+inline void CropByQuadsInto(const OCRStudioSDKImage& src, const double* quads,
+                            const int* sizes, int quads_count,
+                            std::vector<std::unique_ptr<OCRStudioSDKImage> >& dsts,
+                            int num_threads = 0, OCRStudioSDKWorkerPool* pool = nullptr) {
+  const OCRStudioSDKPixelView src_view = PixelView(src);
+  if (quads_count <= 0) {
+    dsts.clear();
+    return;
+  }
+  if (!quads)
+    throw OCRStudioSDKException("InvalidArgumentException", "Quads are null");
+  dsts.resize(static_cast<size_t>(quads_count));
+  std::vector<OCRStudioSDKPixelView> views(static_cast<size_t>(quads_count));
+  for (int i = 0; i < quads_count; ++i) {
+    int width = sizes ? sizes[2 * i] : 0;
+    int height = sizes ? sizes[2 * i + 1] : 0;
+    detail::CheckQuad(quads + 8 * i);
+    if (width <= 0 || height <= 0)
+      detail::EstimateQuadSize(quads + 8 * i, &width, &height);
+    views[i] = PixelView(ReuseOrCreateImage(dsts[i], width, height, src_view.channels));
+  }
+  CropByQuadsInto(src_view, quads, quads_count, views.data(), num_threads, pool);
+}
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_IMAGE_OPS_H_INCLUDED
@@ -0,0 +1,279 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_instance_registry.h
+ * @brief Registry sharing engine instances between users of identical
+ *        configurations (header-only, built on top of the public instance
+ *        interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_INSTANCE_REGISTRY_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_INSTANCE_REGISTRY_H_INCLUDED
+
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_instance.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_hash.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Counters of an instance registry
+ */
+struct OCRStudioSDKInstanceRegistryStats {
+  long long acquisitions;       ///< Calls to Acquire*()
+  long long shared_hits;        ///< Acquisitions served by a live instance
+  long long instances_created;  ///< Instances created by the registry
+  int       live_instances;     ///< Instances currently held by users
+  long long config_bytes;       ///< Configuration bytes of live instances
+};
+
+
+
+/**
+ * @brief Thread-safe registry of engine instances keyed by the content hash
+ *        of the configuration and the canonical initialization parameters.
+ *        Acquiring an instance for a configuration with the same bytes
+ *        returns the live instance already created for it, whatever the file
+ *        name, so the engine memory grows with the number of distinct
+ *        configurations rather than with the number of users. An instance is
+ *        destroyed when the last reference to it is released.
+ *
+ *        Configurations acquired from buffers are kept with their instance
+ *        and compared byte by byte on equal hashes. Configuration files are
+ *        hashed while being read and then loaded by the engine from the
+ *        path, so no copy of them is kept; they are identified by their
+ *        64-bit hash and size only, and must not change while in use.
+ *
+ *        Instances are immutable after creation and CreateSession() is
+ *        const: per-tenant settings (session options, target masks, output
+ *        modes, delegates) belong to the session parameters, so sharing the
+ *        instance does not share any mutable state between tenants.
+ */
+class OCRStudioSDKInstanceRegistry {
+public:
+  /// Main constructor
+  OCRStudioSDKInstanceRegistry()
+    : live_(std::make_shared<LiveCounters>()) {
+    stats_.acquisitions = 0;
+    stats_.shared_hits = 0;
+    stats_.instances_created = 0;
+    stats_.live_instances = 0;
+    stats_.config_bytes = 0;
+  }
+
+  /// Non-copyable
+  OCRStudioSDKInstanceRegistry(const OCRStudioSDKInstanceRegistry&) = delete;
+  OCRStudioSDKInstanceRegistry& operator =(const OCRStudioSDKInstanceRegistry&) = delete;
+
+  /**
+   * @brief Returns an instance for a configuration file, creating it only if
+   *        there is no live instance for the same configuration bytes. The
+   *        file is read once in chunks to be hashed, and a new instance is
+   *        created from the path.
+   * @param configuration_filename - path to a configuration file *.ocr
+   * @param json_instance_init_params - optional JSON with initialization
+   *        parameters, see OCRStudioSDKInstance::CreateFromPath()
+   * @return Shared instance. The registry may be destroyed before it.
+   */
+  std::shared_ptr<OCRStudioSDKInstance> AcquireFromPath(
+      const char* configuration_filename,
+      const char* json_instance_init_params = nullptr) {
+    std::FILE* file = std::fopen(configuration_filename, "rb");
+    if (!file) {
+      throw OCRStudioSDKException(
+          "FileSystemException",
+          ("Cannot open configuration file: " + std::string(configuration_filename)).c_str());
+    }
+    detail::ContentHasher hasher;
+    std::vector<unsigned char> chunk(kReadChunkSize);
+    size_t file_size = 0;
+    size_t read_size;
+    while ((read_size = std::fread(chunk.data(), 1, chunk.size(), file)) > 0) {
+      hasher.Update(chunk.data(), read_size);
+      file_size += read_size;
+    }
+    const bool read_failed = std::ferror(file) != 0;
+    std::fclose(file);
+    if (read_failed || file_size == 0 || file_size > static_cast<size_t>(INT_MAX)) {
+      throw OCRStudioSDKException(
+          "FileSystemException",
+          ("Cannot read configuration file: " + std::string(configuration_filename)).c_str());
+    }
+    std::vector<unsigned char> no_configuration;
+    return Acquire(hasher.Digest(), file_size, no_configuration, configuration_filename,
+                   json_instance_init_params);
+  }
+
+  /**
+   * @brief Returns an instance for a configuration buffer, creating it only
+   *        if there is no live instance for the same configuration bytes
+   * @param configuration_buffer - pointer to a binary configuration buffer,
+   *        copied if a new instance is created
+   * @param configuration_buffer_size - size of the buffer in bytes
+   * @param json_instance_init_params - optional JSON with initialization
+   *        parameters, see OCRStudioSDKInstance::CreateFromBuffer()
+   * @return Shared instance. The registry may be destroyed before it.
+   */
+  std::shared_ptr<OCRStudioSDKInstance> AcquireFromBuffer(
+      const unsigned char* configuration_buffer,
+      int                  configuration_buffer_size,
+      const char*          json_instance_init_params = nullptr) {
+    if (!configuration_buffer || configuration_buffer_size <= 0) {
+      throw OCRStudioSDKException(
+          "InvalidArgumentException", "Empty configuration buffer");
+    }
+    std::vector<unsigned char> configuration(
+        configuration_buffer, configuration_buffer + configuration_buffer_size);
+    const unsigned long long hash =
+        detail::HashBytes(configuration.data(), configuration.size());
+    return Acquire(hash, configuration.size(), configuration, nullptr,
+                   json_instance_init_params);
+  }
+
+  /// Returns the counters of the registry
+  OCRStudioSDKInstanceRegistryStats Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    OCRStudioSDKInstanceRegistryStats stats = stats_;
+    stats.live_instances = live_->instances.load();
+    stats.config_bytes = live_->config_bytes.load();
+    return stats;
+  }
+
+private:
+  static const size_t kReadChunkSize = 1 << 16;  ///< 64 KiB
+
+  /// Counters of live instances, shared with the instances as they may
+  /// outlive the registry
+  struct LiveCounters {
+    std::atomic<int> instances;          ///< live instances
+    std::atomic<long long> config_bytes; ///< their configuration bytes
+
+    LiveCounters()
+      : instances(0),
+        config_bytes(0) {}
+  };
+
+  /// Instance with the configuration buffer it was created from, if any.
+  /// The buffer is kept alive with the instance, as the engine may refer to
+  /// it; the instance is declared last to be destroyed first.
+  struct Entry {
+    std::shared_ptr<LiveCounters> live;             ///< registry counters
+    size_t config_size;                             ///< configuration size
+    std::vector<unsigned char> configuration;       ///< buffer, or empty
+    std::unique_ptr<OCRStudioSDKInstance> instance; ///< engine instance
+
+    Entry()
+      : config_size(0) {}
+
+    ~Entry() {
+      if (instance) {
+        --live->instances;
+        live->config_bytes -= static_cast<long long>(config_size);
+      }
+    }
+  };
+
+  /// Registry slot of a key. Its mutex serializes the creation of the
+  /// instance, so concurrent acquisitions of a new key create it only once,
+  /// while other keys are not blocked.
+  struct Slot {
+    std::mutex mutex;            ///< guards the entry
+    std::weak_ptr<Entry> entry;  ///< live instance, if any
+  };
+
+  typedef std::map<std::string, std::shared_ptr<Slot> > SlotMap;
+
+  /// Returns the live instance for the key of a configuration or creates
+  /// it, from the buffer if one is given, otherwise from the path
+  std::shared_ptr<OCRStudioSDKInstance> Acquire(
+      unsigned long long          hash,
+      size_t                      config_size,
+      std::vector<unsigned char>& configuration,
+      const char*                 configuration_filename,
+      const char*                 json_instance_init_params) {
+    const std::string init_params = json_instance_init_params
+        ? detail::CanonicalJSON(json_instance_init_params) : std::string();
+    const std::string key = std::to_string(hash) + ":" +
+        std::to_string(config_size) + ":" + init_params;
+
+    std::shared_ptr<Slot> slot;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.acquisitions;
+      // Slots of released instances are dropped once nobody waits on them
+      for (SlotMap::iterator it = slots_.begin(); it != slots_.end();) {
+        if (it->first != key && it->second.use_count() == 1 && it->second->entry.expired())
+          it = slots_.erase(it);
+        else
+          ++it;
+      }
+      std::shared_ptr<Slot>& slot_ref = slots_[key];
+      if (!slot_ref)
+        slot_ref = std::make_shared<Slot>();
+      slot = slot_ref;
+    }
+
+    std::shared_ptr<Entry> entry;
+    bool shared;
+    {
+      std::lock_guard<std::mutex> slot_lock(slot->mutex);
+      entry = slot->entry.lock();
+      // Equal hashes of different buffers are not shared; configurations
+      // read from files can only be compared by their keys
+      shared = entry && (configuration.empty() || entry->configuration.empty() ||
+                         entry->configuration == configuration);
+      if (!shared) {
+        entry = std::make_shared<Entry>();
+        entry->live = live_;
+        entry->config_size = config_size;
+        if (configuration.empty()) {
+          entry->instance.reset(OCRStudioSDKInstance::CreateFromPath(
+              configuration_filename, json_instance_init_params));
+        } else {
+          entry->configuration.swap(configuration);
+          entry->instance.reset(OCRStudioSDKInstance::CreateFromBuffer(
+              entry->configuration.data(),
+              static_cast<int>(entry->configuration.size()),
+              json_instance_init_params));
+        }
+        ++live_->instances;
+        live_->config_bytes += static_cast<long long>(config_size);
+        if (slot->entry.expired())
+          slot->entry = entry;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shared)
+      ++stats_.shared_hits;
+    else
+      ++stats_.instances_created;
+    OCRStudioSDKInstance* instance = entry->instance.get();
+    return std::shared_ptr<OCRStudioSDKInstance>(entry, instance);
+  }
+
+private:
+  mutable std::mutex mutex_;                 ///< guards the fields below
+  SlotMap slots_;                            ///< slots per configuration key
+  OCRStudioSDKInstanceRegistryStats stats_;  ///< cumulative counters
+  const std::shared_ptr<LiveCounters> live_; ///< live instances counters
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_INSTANCE_REGISTRY_H_INCLUDED
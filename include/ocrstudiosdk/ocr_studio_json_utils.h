@@ -0,0 +1,407 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_json_utils.h
+ * @brief Minimal JSON helpers shared by the header-only utilities
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_JSON_UTILS_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_JSON_UTILS_H_INCLUDED
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ocrstudio {
+namespace detail {
+
+/**
+ * @brief Appends a string to a JSON document as a quoted and escaped
+ *        JSON string literal
+ * @param out - output JSON document
+ * @param str - the string to be appended (UTF-8)
+ */
+inline void AppendJSONString(std::string& out, const char* str) {
+  out += '"';
+  for (const char* c = str; *c; ++c) {
+    switch (*c) {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\b': out += "\\b";  break;
+      case '\f': out += "\\f";  break;
+      case '\n': out += "\\n";  break;
+      case '\r': out += "\\r";  break;
+      case '\t': out += "\\t";  break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04x",
+                        static_cast<unsigned int>(static_cast<unsigned char>(*c)));
+          out += buf;
+        } else {
+          out += *c;
+        }
+    }
+  }
+  out += '"';
+}
+
+/// Appends an integer to a JSON document
+inline void AppendJSONNumber(std::string& out, long long value) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%lld", value);
+  out += buf;
+}
+
+/// Appends a floating-point number to a JSON document
+inline void AppendJSONNumber(std::string& out, double value) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.6g", value);
+  out += buf;
+}
+
+/**
+ * @brief Recursive-descent canonicalizer of JSON documents: re-emits a value
+ *        without insignificant whitespace and with object keys sorted, so
+ *        that semantically equal documents produce equal strings
+ */
+class JSONCanonicalizer {
+public:
+  /// Constructor from a JSON document
+  explicit JSONCanonicalizer(const char* json)
+    : pos_(json) {}
+
+  /**
+   * @brief Canonicalizes the document
+   * @param out - output canonical representation
+   * @return true if the document is a valid JSON value
+   */
+  bool Canonicalize(std::string& out) {
+    out.clear();
+    if (!ParseValue(out))
+      return false;
+    SkipWhitespace();
+    return *pos_ == '\0';
+  }
+
+private:
+  void SkipWhitespace() {
+    while (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\n' || *pos_ == '\r')
+      ++pos_;
+  }
+
+  bool ParseValue(std::string& out) {
+    SkipWhitespace();
+    switch (*pos_) {
+      case '{': return ParseObject(out);
+      case '[': return ParseArray(out);
+      case '"': return ParseString(out);
+      default:  return ParseLiteral(out);
+    }
+  }
+
+  /// Copies a string literal verbatim, escape sequences included
+  bool ParseString(std::string& out) {
+    const char* start = pos_++;
+    while (*pos_ != '"') {
+      if (*pos_ == '\0')
+        return false;
+      if (*pos_ == '\\' && *(++pos_) == '\0')
+        return false;
+      ++pos_;
+    }
+    ++pos_;
+    out.append(start, pos_);
+    return true;
+  }
+
+  /// Copies a number, true, false or null
+  bool ParseLiteral(std::string& out) {
+    const char* start = pos_;
+    while ((*pos_ >= '0' && *pos_ <= '9') || (*pos_ >= 'a' && *pos_ <= 'z') ||
+           *pos_ == '-' || *pos_ == '+' || *pos_ == '.' || *pos_ == 'E')
+      ++pos_;
+    if (pos_ == start)
+      return false;
+    out.append(start, pos_);
+    return true;
+  }
+
+  bool ParseArray(std::string& out) {
+    ++pos_;
+    out += '[';
+    SkipWhitespace();
+    if (*pos_ == ']') {
+      ++pos_;
+      out += ']';
+      return true;
+    }
+    for (;;) {
+      if (!ParseValue(out))
+        return false;
+      SkipWhitespace();
+      if (*pos_ == ']')
+        break;
+      if (*pos_ != ',')
+        return false;
+      ++pos_;
+      out += ',';
+    }
+    ++pos_;
+    out += ']';
+    return true;
+  }
+
+  bool ParseObject(std::string& out) {
+    ++pos_;
+    std::map<std::string, std::string> members;
+    SkipWhitespace();
+    if (*pos_ != '}') {
+      for (;;) {
+        SkipWhitespace();
+        std::string key, value;
+        if (*pos_ != '"' || !ParseString(key))
+          return false;
+        SkipWhitespace();
+        if (*pos_ != ':')
+          return false;
+        ++pos_;
+        if (!ParseValue(value))
+          return false;
+        members[key] = value;
+        SkipWhitespace();
+        if (*pos_ == '}')
+          break;
+        if (*pos_ != ',')
+          return false;
+        ++pos_;
+      }
+    }
+    ++pos_;
+    out += '{';
+    for (std::map<std::string, std::string>::const_iterator it = members.begin();
+         it != members.end(); ++it) {
+      if (it != members.begin())
+        out += ',';
+      out += it->first;
+      out += ':';
+      out += it->second;
+    }
+    out += '}';
+    return true;
+  }
+
+private:
+  const char* pos_;  ///< current parsing position
+};
+
+/**
+ * @brief Returns the canonical form of a JSON document, see JSONCanonicalizer.
+ *        Invalid documents are returned as-is.
+ */
+inline std::string CanonicalJSON(const char* json) {
+  std::string canonical;
+  if (!json || !JSONCanonicalizer(json).Canonicalize(canonical))
+    return json ? std::string(json) : std::string();
+  return canonical;
+}
+
+/**
+ * @brief Finds a member of the top-level object of a canonical JSON document
+ * @param canonical - JSON document in the form produced by JSONCanonicalizer
+ * @param key - name of the member
+ * @return Position of the member value, or std::string::npos if not found
+ */
+inline size_t FindJSONMember(const std::string& canonical, const char* key) {
+  if (canonical.empty() || canonical[0] != '{')
+    return std::string::npos;
+
+  // In the canonical form there is no whitespace, so the member can be
+  // found by walking the top-level object while tracking the nesting depth
+  const std::string member = "\"" + std::string(key) + "\":";
+  int depth = 0;
+  bool in_string = false;
+  for (size_t i = 0; i < canonical.size(); ++i) {
+    const char c = canonical[i];
+    if (in_string) {
+      if (c == '\\')
+        ++i;
+      else if (c == '"')
+        in_string = false;
+      continue;
+    }
+    if (c == '{' || c == '[') {
+      ++depth;
+    } else if (c == '}' || c == ']') {
+      --depth;
+    } else if (c == '"') {
+      if (depth == 1 && canonical.compare(i, member.size(), member) == 0)
+        return i + member.size();
+      in_string = true;
+    }
+  }
+  return std::string::npos;
+}
+
+/// Returns the end of the string starting at pos (the closing quote)
+inline size_t FindJSONStringEnd(const std::string& canonical, size_t pos) {
+  size_t end = pos + 1;
+  while (end < canonical.size() && canonical[end] != '"')
+    end += (canonical[end] == '\\') ? 2 : 1;
+  return end;
+}
+
+/// Appends a code point to a UTF-8 string
+inline void AppendUTF8(std::string& out, unsigned long code_point) {
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xC0 | (code_point >> 6));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xE0 | (code_point >> 12));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (code_point >> 18));
+    out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+/// Reads the 4 hex digits of a unicode escape, returns false if malformed
+inline bool ReadJSONHex4(const std::string& str, size_t pos, unsigned long& value) {
+  if (pos + 4 > str.size())
+    return false;
+  value = 0;
+  for (size_t i = pos; i < pos + 4; ++i) {
+    const char c = str[i];
+    value <<= 4;
+    if (c >= '0' && c <= '9')
+      value |= static_cast<unsigned long>(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      value |= static_cast<unsigned long>(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      value |= static_cast<unsigned long>(c - 'A' + 10);
+    else
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Decodes the escape sequences of the contents of a JSON string
+ *        literal, as returned by ExtractJSONString(). Malformed escapes and
+ *        unpaired surrogates are replaced with U+FFFD.
+ * @param escaped - string contents without the quotes
+ * @return Decoded UTF-8 string
+ */
+inline std::string DecodeJSONString(const std::string& escaped) {
+  std::string out;
+  out.reserve(escaped.size());
+  for (size_t i = 0; i < escaped.size(); ++i) {
+    if (escaped[i] != '\\' || i + 1 == escaped.size()) {
+      out += escaped[i];
+      continue;
+    }
+    const char c = escaped[++i];
+    switch (c) {
+      case 'b': out += '\b'; break;
+      case 'f': out += '\f'; break;
+      case 'n': out += '\n'; break;
+      case 'r': out += '\r'; break;
+      case 't': out += '\t'; break;
+      case 'u': {
+        unsigned long code_point;
+        if (!ReadJSONHex4(escaped, i + 1, code_point)) {
+          AppendUTF8(out, 0xFFFD);
+          break;
+        }
+        i += 4;
+        if (code_point >= 0xD800 && code_point < 0xDC00) {
+          unsigned long low;
+          if (i + 2 < escaped.size() && escaped[i + 1] == '\\' && escaped[i + 2] == 'u' &&
+              ReadJSONHex4(escaped, i + 3, low) && low >= 0xDC00 && low < 0xE000) {
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+            i += 6;
+          } else {
+            code_point = 0xFFFD;
+          }
+        } else if (code_point >= 0xDC00 && code_point < 0xE000) {
+          code_point = 0xFFFD;
+        }
+        AppendUTF8(out, code_point);
+        break;
+      }
+      default: out += c; // '"', '\\' and '/'
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Extracts a string stored under a key of the top-level JSON object,
+ *        e.g. "session_type" of session parameters. Escape sequences in the
+ *        string are not decoded.
+ * @param json - JSON document with an object at the top level
+ * @param key - name of the member holding the string
+ * @param value - output string, cleared before extraction
+ * @return true if the member exists and is a string
+ */
+inline bool ExtractJSONString(const char* json, const char* key, std::string& value) {
+  value.clear();
+  std::string canonical;
+  if (!json || !JSONCanonicalizer(json).Canonicalize(canonical))
+    return false;
+  const size_t pos = FindJSONMember(canonical, key);
+  if (pos == std::string::npos || pos >= canonical.size() || canonical[pos] != '"')
+    return false;
+  const size_t end = FindJSONStringEnd(canonical, pos);
+  value = canonical.substr(pos + 1, end - pos - 1);
+  return true;
+}
+
+/**
+ * @brief Extracts an array of strings stored under a key of the top-level
+ *        JSON object, e.g. "item_types" of a target description. The strings
+ *        are decoded, see DecodeJSONString(), so they can be passed to the
+ *        SDK as is.
+ * @param json - JSON document with an object at the top level
+ * @param key - name of the member holding the array
+ * @param values - output strings, cleared before extraction
+ * @return true if the member exists and is an array of strings
+ */
+inline bool ExtractJSONStringArray(
+    const char* json, const char* key, std::vector<std::string>& values) {
+  values.clear();
+  std::string canonical;
+  if (!json || !JSONCanonicalizer(json).Canonicalize(canonical))
+    return false;
+  size_t pos = FindJSONMember(canonical, key);
+  if (pos == std::string::npos || pos >= canonical.size() || canonical[pos] != '[')
+    return false;
+  ++pos;
+  while (pos < canonical.size() && canonical[pos] == '"') {
+    const size_t end = FindJSONStringEnd(canonical, pos);
+    values.push_back(DecodeJSONString(canonical.substr(pos + 1, end - pos - 1)));
+    pos = end + 1;
+    if (pos < canonical.size() && canonical[pos] == ',')
+      ++pos;
+  }
+  if (pos >= canonical.size() || canonical[pos] != ']') {
+    values.clear();
+    return false;
+  }
+  return true;
+}
+
+} // namespace detail
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_JSON_UTILS_H_INCLUDED
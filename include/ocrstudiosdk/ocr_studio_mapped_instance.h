@@ -0,0 +1,136 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_mapped_instance.h
+ * @brief Creation of an engine instance from a memory-mapped configuration
+ *        file (header-only, POSIX)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_MAPPED_INSTANCE_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_MAPPED_INSTANCE_H_INCLUDED
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ocrstudiosdk/ocr_studio_instance.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Engine instance created from a configuration file mapped into
+ *        memory, instead of a configuration buffer read into the heap.
+ *        The file pages are backed by the page cache, so they are not
+ *        duplicated in the private memory of the process and are shared
+ *        between processes mapping the same file, up to the point where the
+ *        engine copies them into its own structures. The mapping is kept
+ *        for the whole lifetime of the instance.
+ */
+class OCRStudioSDKMappedInstance {
+public:
+  /**
+   * @brief Maps a configuration file and creates an instance from it
+   * @param configuration_filename - path to a configuration file *.ocr
+   * @param json_instance_init_params - optional JSON with initialization
+   *        parameters, see OCRStudioSDKInstance::CreateFromBuffer()
+   */
+  explicit OCRStudioSDKMappedInstance(
+      const char* configuration_filename,
+      const char* json_instance_init_params = nullptr)
+    : mapping_(nullptr),
+      mapping_size_(0) {
+    const int fd = ::open(configuration_filename, O_RDONLY);
+    if (fd < 0)
+      ThrowSystemError("Cannot open configuration file", configuration_filename);
+
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) != 0) {
+      const int saved_errno = errno;
+      ::close(fd);
+      errno = saved_errno;
+      ThrowSystemError("Cannot stat configuration file", configuration_filename);
+    }
+    if (file_stat.st_size <= 0 || file_stat.st_size > INT_MAX) {
+      ::close(fd);
+      throw OCRStudioSDKException(
+          "FileSystemException",
+          ("Unsupported configuration file size: " +
+           std::string(configuration_filename)).c_str());
+    }
+
+    // The buffer parameter of CreateFromBuffer() is not const, so the file
+    // is mapped copy-on-write: pages stay shared unless they are modified
+    mapping_size_ = static_cast<size_t>(file_stat.st_size);
+    void* mapping = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE, fd, 0);
+    const int saved_errno = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+      errno = saved_errno;
+      ThrowSystemError("Cannot map configuration file", configuration_filename);
+    }
+    mapping_ = static_cast<unsigned char*>(mapping);
+
+    try {
+      instance_.reset(OCRStudioSDKInstance::CreateFromBuffer(
+          mapping_, static_cast<int>(mapping_size_), json_instance_init_params));
+    } catch (...) {
+      ::munmap(mapping_, mapping_size_);
+      throw;
+    }
+  }
+
+  /// Non-copyable
+  OCRStudioSDKMappedInstance(const OCRStudioSDKMappedInstance&) = delete;
+  OCRStudioSDKMappedInstance& operator =(const OCRStudioSDKMappedInstance&) = delete;
+
+  /// Destructor, destroys the instance and unmaps the file
+  ~OCRStudioSDKMappedInstance() {
+    instance_.reset();
+    ::munmap(mapping_, mapping_size_);
+  }
+
+  /// Returns the engine instance
+  OCRStudioSDKInstance& Instance() {
+    return *instance_;
+  }
+
+  /// Returns the engine instance (const ref)
+  const OCRStudioSDKInstance& Instance() const {
+    return *instance_;
+  }
+
+  /// Returns the size of the mapped configuration file in bytes
+  size_t MappedSize() const {
+    return mapping_size_;
+  }
+
+private:
+  /// Throws an exception describing errno
+  static void ThrowSystemError(const char* what, const char* filename) {
+    const std::string message =
+        std::string(what) + " " + filename + ": " + std::strerror(errno);
+    throw OCRStudioSDKException("FileSystemException", message.c_str());
+  }
+
+private:
+  unsigned char* mapping_;                        ///< mapped file contents
+  size_t mapping_size_;                           ///< mapped size in bytes
+  std::unique_ptr<OCRStudioSDKInstance> instance_;///< engine instance
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_MAPPED_INSTANCE_H_INCLUDED
@@ -0,0 +1,394 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_metrics_registry.h
+ * @brief Process-wide session statistics in the Prometheus text format
+ *        (header-only, built on top of the public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_METRICS_REGISTRY_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_METRICS_REGISTRY_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_instance.h>
+#include <ocrstudiosdk/ocr_studio_session.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+#include <ocrstudiosdk/ocr_studio_buffer_pool.h>
+
+namespace ocrstudio {
+
+namespace detail {
+
+/// Upper bounds of the latency histogram buckets in seconds, followed by +Inf
+const int kLatencyBucketsCount = 12;
+
+inline double LatencyBucketBound(int bucket) {
+  static const double bounds[kLatencyBucketsCount - 1] = {
+      0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+  return bounds[bucket];
+}
+
+/// Counters of the sessions with the same session type and target group
+struct SessionSeries {
+  SessionSeries(const std::string& session_type_label,
+                const std::string& target_group_label)
+    : session_type(session_type_label), target_group_type(target_group_label),
+      sessions_active(0), sessions_created(0), images_processed(0),
+      data_processed(0), latency_sum_us(0) {
+    for (int i = 0; i < kLatencyBucketsCount; ++i)
+      latency_buckets[i].store(0);
+  }
+
+  const std::string session_type;        ///< label value
+  const std::string target_group_type;   ///< label value
+  std::atomic<long long> sessions_active;
+  std::atomic<long long> sessions_created;
+  std::atomic<long long> images_processed;
+  std::atomic<long long> data_processed;
+  /// ProcessImage() latencies per bucket (not cumulative)
+  std::atomic<long long> latency_buckets[kLatencyBucketsCount];
+  std::atomic<long long> latency_sum_us;
+};
+
+/// Appends a label value, escaped for the Prometheus text format
+inline void AppendLabelValue(std::string& out, const std::string& value) {
+  for (size_t i = 0; i < value.size(); ++i) {
+    const char c = value[i];
+    if (c == '\\' || c == '"')
+      out += '\\';
+    if (c == '\n')
+      out += "\\n";
+    else
+      out += c;
+  }
+}
+
+} // namespace detail
+
+class OCRStudioSDKMetricsRegistry;
+
+
+
+/**
+ * @brief Session wrapper reporting to an OCRStudioSDKMetricsRegistry,
+ *        created with OCRStudioSDKMetricsRegistry::CreateSession() or
+ *        OCRStudioSDKMetricsRegistry::Instrument()
+ */
+class OCRStudioSDKInstrumentedSession : public OCRStudioSDKSession {
+public:
+  /// Destructor, releases the wrapped session
+  virtual ~OCRStudioSDKInstrumentedSession() override {
+    series_.sessions_active.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /// Returns the wrapped session
+  OCRStudioSDKSession& Session() {
+    return *session_;
+  }
+
+  virtual const char* Description() const override {
+    return session_->Description();
+  }
+
+  inline virtual void ProcessImage(const OCRStudioSDKImage& image) override;
+
+  inline virtual void ProcessData(const char* data_str) override;
+
+  virtual const OCRStudioSDKResult& CurrentResult() const override {
+    return session_->CurrentResult();
+  }
+
+  virtual void Reset() override {
+    session_->Reset();
+  }
+
+  virtual void Suspend() override {
+    session_->Suspend();
+  }
+
+  virtual void Resume() override {
+    session_->Resume();
+  }
+
+private:
+  friend class OCRStudioSDKMetricsRegistry;
+
+  OCRStudioSDKInstrumentedSession(OCRStudioSDKSession* session,
+                                  OCRStudioSDKMetricsRegistry& registry,
+                                  detail::SessionSeries& series)
+    : session_(session), registry_(registry), series_(series) {
+    series_.sessions_active.fetch_add(1, std::memory_order_relaxed);
+    series_.sessions_created.fetch_add(1, std::memory_order_relaxed);
+  }
+
+private:
+  std::unique_ptr<OCRStudioSDKSession> session_;  ///< wrapped session
+  OCRStudioSDKMetricsRegistry& registry_;         ///< registry to report to
+  detail::SessionSeries& series_;                 ///< counters of the session
+};
+
+
+
+/**
+ * @brief Registry of statistics across all sessions of one or several engine
+ *        instances. Sessions report to the registry when created through it;
+ *        successful processing calls only update atomic counters, so the
+ *        registry adds no locking to the processing path. The registry must
+ *        outlive its sessions.
+ *
+ *        TextDump() returns the statistics in the Prometheus text exposition
+ *        format, labelled by the session type and the target group type:
+ *          ocrstudiosdk_sessions_active (gauge)
+ *          ocrstudiosdk_sessions_created_total (counter)
+ *          ocrstudiosdk_images_processed_total (counter)
+ *          ocrstudiosdk_data_processed_total (counter)
+ *          ocrstudiosdk_process_image_seconds (histogram)
+ *          ocrstudiosdk_exceptions_total, labelled by the exception type
+ *            (InternalException for exceptions of other classes)
+ *          ocrstudiosdk_buffer_pool_bytes, memory of OCRStudioSDKBufferPool
+ */
+class OCRStudioSDKMetricsRegistry {
+public:
+  /// Main constructor
+  OCRStudioSDKMetricsRegistry() = default;
+
+  /// Non-copyable
+  OCRStudioSDKMetricsRegistry(const OCRStudioSDKMetricsRegistry&) = delete;
+  OCRStudioSDKMetricsRegistry& operator =(const OCRStudioSDKMetricsRegistry&) = delete;
+
+  /**
+   * @brief Creates a session reporting to the registry, see
+   *        OCRStudioSDKInstance::CreateSession()
+   * @param instance - the configured engine instance
+   * @param authorization_signature - personalized signature
+   * @param json_session_params - session parameters in JSON format
+   * @param callback_delegate - optional feedback delegate
+   * @return Pointer to a new session, the ownership is relinquished.
+   */
+  OCRStudioSDKInstrumentedSession* CreateSession(
+      const OCRStudioSDKInstance& instance,
+      const char*                 authorization_signature,
+      const char*                 json_session_params,
+      OCRStudioSDKDelegate*       callback_delegate = nullptr) {
+    OCRStudioSDKSession* session = nullptr;
+    try {
+      session = instance.CreateSession(
+          authorization_signature, json_session_params, callback_delegate);
+    } catch (const OCRStudioSDKException& e) {
+      RecordException(e);
+      throw;
+    } catch (...) {
+      RecordExceptionType("InternalException");
+      throw;
+    }
+    return Instrument(session, json_session_params);
+  }
+
+  /**
+   * @brief Wraps an existing session to report to the registry
+   * @param session - session to be wrapped, the ownership is taken
+   * @param json_session_params - parameters the session was created with,
+   *        used for the labels
+   * @return Pointer to a new session, the ownership is relinquished.
+   */
+  OCRStudioSDKInstrumentedSession* Instrument(
+      OCRStudioSDKSession* session, const char* json_session_params) {
+    std::unique_ptr<OCRStudioSDKSession> owned(session);
+    std::string session_type, target_group_type;
+    // Labels are kept decoded and escaped for the text format on export
+    detail::ExtractJSONString(json_session_params, "session_type", session_type);
+    detail::ExtractJSONString(json_session_params, "target_group_type", target_group_type);
+    detail::SessionSeries& series = Series(detail::DecodeJSONString(session_type),
+                                           detail::DecodeJSONString(target_group_type));
+    return new OCRStudioSDKInstrumentedSession(owned.release(), *this, series);
+  }
+
+  /**
+   * @brief Counts an exception by its type. Called by the instrumented
+   *        sessions; may also be called for exceptions thrown elsewhere.
+   * @param exception - the thrown exception
+   */
+  void RecordException(const OCRStudioSDKException& exception) {
+    RecordExceptionType(exception.Type() ? exception.Type() : "");
+  }
+
+  /// Returns the statistics in the Prometheus text exposition format
+  std::string TextDump() const {
+    std::vector<const detail::SessionSeries*> series;
+    std::map<std::string, long long> exceptions;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t i = 0; i < series_.size(); ++i)
+        series.push_back(series_[i].get());
+      exceptions = exceptions_;
+    }
+
+    std::string out;
+    AppendSeriesMetric(out, series, "ocrstudiosdk_sessions_active", "gauge",
+                       "Number of existing sessions",
+                       &detail::SessionSeries::sessions_active);
+    AppendSeriesMetric(out, series, "ocrstudiosdk_sessions_created_total", "counter",
+                       "Number of created sessions",
+                       &detail::SessionSeries::sessions_created);
+    AppendSeriesMetric(out, series, "ocrstudiosdk_images_processed_total", "counter",
+                       "Number of successful ProcessImage() calls",
+                       &detail::SessionSeries::images_processed);
+    AppendSeriesMetric(out, series, "ocrstudiosdk_data_processed_total", "counter",
+                       "Number of successful ProcessData() calls",
+                       &detail::SessionSeries::data_processed);
+
+    out += "# HELP ocrstudiosdk_process_image_seconds Duration of successful "
+           "ProcessImage() calls\n"
+           "# TYPE ocrstudiosdk_process_image_seconds histogram\n";
+    for (size_t i = 0; i < series.size(); ++i) {
+      std::string labels;
+      AppendSeriesLabels(labels, *series[i]);
+      long long cumulative = 0;
+      for (int bucket = 0; bucket < detail::kLatencyBucketsCount; ++bucket) {
+        cumulative += series[i]->latency_buckets[bucket].load(std::memory_order_relaxed);
+        out += "ocrstudiosdk_process_image_seconds_bucket{" + labels + ",le=\"";
+        if (bucket + 1 < detail::kLatencyBucketsCount)
+          detail::AppendJSONNumber(out, detail::LatencyBucketBound(bucket));
+        else
+          out += "+Inf";
+        out += "\"} ";
+        detail::AppendJSONNumber(out, cumulative);
+        out += "\n";
+      }
+      out += "ocrstudiosdk_process_image_seconds_sum{" + labels + "} ";
+      detail::AppendJSONNumber(
+          out, series[i]->latency_sum_us.load(std::memory_order_relaxed) / 1e6);
+      out += "\nocrstudiosdk_process_image_seconds_count{" + labels + "} ";
+      detail::AppendJSONNumber(out, cumulative);
+      out += "\n";
+    }
+
+    out += "# HELP ocrstudiosdk_exceptions_total Number of thrown exceptions by type\n"
+           "# TYPE ocrstudiosdk_exceptions_total counter\n";
+    for (std::map<std::string, long long>::const_iterator it = exceptions.begin();
+         it != exceptions.end(); ++it) {
+      out += "ocrstudiosdk_exceptions_total{type=\"";
+      detail::AppendLabelValue(out, it->first);
+      out += "\"} ";
+      detail::AppendJSONNumber(out, it->second);
+      out += "\n";
+    }
+
+    const OCRStudioSDKBufferPoolStats pool = OCRStudioSDKBufferPool::Instance().Stats();
+    out += "# HELP ocrstudiosdk_buffer_pool_bytes Memory of the buffer pool\n"
+           "# TYPE ocrstudiosdk_buffer_pool_bytes gauge\n"
+           "ocrstudiosdk_buffer_pool_bytes{state=\"in_use\"} ";
+    detail::AppendJSONNumber(out, pool.bytes_in_use);
+    out += "\nocrstudiosdk_buffer_pool_bytes{state=\"cached\"} ";
+    detail::AppendJSONNumber(out, pool.bytes_cached);
+    out += "\n";
+    return out;
+  }
+
+private:
+  friend class OCRStudioSDKInstrumentedSession;
+
+  /// Counts an exception of the given type
+  void RecordExceptionType(const std::string& type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++exceptions_[type];
+  }
+
+  /// Returns the counters for the labels, creating them on first use
+  detail::SessionSeries& Series(const std::string& session_type,
+                                const std::string& target_group_type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < series_.size(); ++i) {
+      if (series_[i]->session_type == session_type &&
+          series_[i]->target_group_type == target_group_type)
+        return *series_[i];
+    }
+    series_.emplace_back(new detail::SessionSeries(session_type, target_group_type));
+    return *series_.back();
+  }
+
+  static void RecordLatency(detail::SessionSeries& series, double seconds) {
+    int bucket = 0;
+    while (bucket + 1 < detail::kLatencyBucketsCount &&
+           seconds > detail::LatencyBucketBound(bucket))
+      ++bucket;
+    series.latency_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    series.latency_sum_us.fetch_add(static_cast<long long>(seconds * 1e6),
+                                    std::memory_order_relaxed);
+  }
+
+  static void AppendSeriesLabels(std::string& out, const detail::SessionSeries& series) {
+    out += "session_type=\"";
+    detail::AppendLabelValue(out, series.session_type);
+    out += "\",target_group_type=\"";
+    detail::AppendLabelValue(out, series.target_group_type);
+    out += "\"";
+  }
+
+  static void AppendSeriesMetric(
+      std::string& out, const std::vector<const detail::SessionSeries*>& series,
+      const char* name, const char* type, const char* help,
+      std::atomic<long long> detail::SessionSeries::*counter) {
+    out += std::string("# HELP ") + name + " " + help + "\n# TYPE " + name + " " + type + "\n";
+    for (size_t i = 0; i < series.size(); ++i) {
+      out += std::string(name) + "{";
+      AppendSeriesLabels(out, *series[i]);
+      out += "} ";
+      detail::AppendJSONNumber(out, (series[i]->*counter).load(std::memory_order_relaxed));
+      out += "\n";
+    }
+  }
+
+private:
+  mutable std::mutex mutex_;  ///< guards the fields below
+  /// Counters by labels, never removed so that sessions may keep references
+  std::vector<std::unique_ptr<detail::SessionSeries> > series_;
+  std::map<std::string, long long> exceptions_;  ///< exception counts by type
+};
+
+
+
+inline void OCRStudioSDKInstrumentedSession::ProcessImage(const OCRStudioSDKImage& image) {
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  try {
+    session_->ProcessImage(image);
+  } catch (const OCRStudioSDKException& e) {
+    registry_.RecordException(e);
+    throw;
+  } catch (...) {
+    registry_.RecordExceptionType("InternalException");
+    throw;
+  }
+  OCRStudioSDKMetricsRegistry::RecordLatency(
+      series_, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  series_.images_processed.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void OCRStudioSDKInstrumentedSession::ProcessData(const char* data_str) {
+  try {
+    session_->ProcessData(data_str);
+  } catch (const OCRStudioSDKException& e) {
+    registry_.RecordException(e);
+    throw;
+  } catch (...) {
+    registry_.RecordExceptionType("InternalException");
+    throw;
+  }
+  series_.data_processed.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_METRICS_REGISTRY_H_INCLUDED
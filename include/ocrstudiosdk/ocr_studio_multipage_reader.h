@@ -0,0 +1,295 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_multipage_reader.h
+ * @brief Reader of multi-page image files (TIFF, PDF) with parallel page
+ *        decoding (header-only, built on top of the public image interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_MULTIPAGE_READER_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_MULTIPAGE_READER_H_INCLUDED
+
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_image.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+
+namespace ocrstudio {
+namespace detail {
+
+/// Reads an unsigned TIFF field of the given size in bytes
+inline uint64_t ReadTIFFValue(const unsigned char* pos, int size, bool big_endian) {
+  uint64_t value = 0;
+  for (int i = 0; i < size; ++i)
+    value = (value << 8) | pos[big_endian ? i : size - 1 - i];
+  return value;
+}
+
+/**
+ * @brief Counts the pages of an image file from its contents: the image file
+ *        directories of a TIFF or BigTIFF file, or one page for PNG and JPEG
+ * @param data - contents of the file
+ * @param size - size of the contents in bytes
+ * @return Number of pages, or 0 if the format is not recognized or the TIFF
+ *         directory chain is malformed
+ */
+inline int CountFileBufferPages(const unsigned char* data, size_t size) {
+  static const unsigned char kPNGSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  if (size >= sizeof(kPNGSignature) &&
+      std::memcmp(data, kPNGSignature, sizeof(kPNGSignature)) == 0)
+    return 1;
+  if (size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF)
+    return 1;
+
+  if (size < 8 || !((data[0] == 'I' && data[1] == 'I') || (data[0] == 'M' && data[1] == 'M')))
+    return 0;
+  const bool big_endian = data[0] == 'M';
+  const uint64_t version = ReadTIFFValue(data + 2, 2, big_endian);
+  if (version != 42 && version != 43)
+    return 0;
+  // BigTIFF uses 64-bit offsets and counts and 20-byte directory entries
+  const int offset_size = version == 43 ? 8 : 4;
+  const int count_size = version == 43 ? 8 : 2;
+  const uint64_t entry_size = version == 43 ? 20 : 12;
+  const size_t header_size = version == 43 ? 16 : 8;
+  if (size < header_size)
+    return 0;
+
+  uint64_t offset = ReadTIFFValue(data + header_size - offset_size, offset_size, big_endian);
+  // Every directory takes at least its count and next offset, which bounds
+  // the number of pages and stops cyclic chains
+  const uint64_t max_pages = size / static_cast<uint64_t>(count_size + offset_size);
+  uint64_t pages = 0;
+  while (offset != 0) {
+    if (offset < header_size || offset > size - count_size || ++pages > max_pages ||
+        pages > static_cast<uint64_t>(INT_MAX))
+      return 0;
+    const uint64_t entries = ReadTIFFValue(data + offset, count_size, big_endian);
+    const uint64_t next_pos = offset + count_size;
+    if (entries > (size - next_pos) / entry_size ||
+        size - next_pos - entries * entry_size < static_cast<uint64_t>(offset_size))
+      return 0;
+    offset = ReadTIFFValue(data + next_pos + entries * entry_size, offset_size, big_endian);
+  }
+  return static_cast<int>(pages);
+}
+
+} // namespace detail
+
+
+
+/**
+ * @brief Reads the pages of a multi-page image file in order. The file is
+ *        read from disk once and every page is decoded from the in-memory
+ *        buffer, instead of reopening the file for each page. Pages ahead
+ *        of the current one are decoded in parallel, up to the prefetch
+ *        depth, by at most kMaxDecodeThreads background threads, so decoding
+ *        overlaps with the processing of the pages already returned. The
+ *        number of pages of TIFF files is read from the buffer; for other
+ *        multi-page formats (PDF) it is queried from the library.
+ *
+ *        The reader is not thread-safe, except for DecodePage().
+ */
+class OCRStudioSDKMultiPageReader {
+public:
+  /**
+   * @brief Main constructor, reads the file into memory
+   * @param filename - path to an image file
+   * @param prefetch_depth - maximum number of pages decoded in the background
+   *        ahead of the current one (0 for the number of hardware threads).
+   *        They are decoded by min(prefetch_depth, kMaxDecodeThreads) threads.
+   * @param max_width - maximum image width in pixels (0 for unrestricted)
+   * @param max_height - maximum image height in pixels (0 for unrestricted)
+   */
+  explicit OCRStudioSDKMultiPageReader(
+      const char* filename,
+      int         prefetch_depth = 0,
+      int         max_width = 25000,
+      int         max_height = 25000)
+    : max_width_(max_width),
+      max_height_(max_height),
+      next_page_(0),
+      next_scheduled_page_(0),
+      stopping_(false) {
+    std::FILE* file = std::fopen(filename, "rb");
+    if (!file) {
+      throw OCRStudioSDKException(
+          "FileSystemException",
+          ("Cannot open image file: " + std::string(filename)).c_str());
+    }
+    std::fseek(file, 0, SEEK_END);
+    const long file_size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (file_size > 0 && file_size <= INT_MAX) {
+      data_.resize(static_cast<size_t>(file_size));
+      if (std::fread(data_.data(), 1, data_.size(), file) != data_.size())
+        data_.clear();
+    }
+    std::fclose(file);
+    if (data_.empty()) {
+      throw OCRStudioSDKException(
+          "FileSystemException",
+          ("Cannot read image file: " + std::string(filename)).c_str());
+    }
+
+    pages_count_ = detail::CountFileBufferPages(data_.data(), data_.size());
+    if (pages_count_ <= 0)
+      pages_count_ = OCRStudioSDKImage::PagesCount(filename);
+    if (prefetch_depth <= 0)
+      prefetch_depth = static_cast<int>(std::thread::hardware_concurrency());
+    prefetch_depth_ = prefetch_depth > 0 ? prefetch_depth : 1;
+    max_threads_ = prefetch_depth_;
+    if (max_threads_ > kMaxDecodeThreads)
+      max_threads_ = kMaxDecodeThreads;
+  }
+
+  /// Non-copyable
+  OCRStudioSDKMultiPageReader(const OCRStudioSDKMultiPageReader&) = delete;
+  OCRStudioSDKMultiPageReader& operator =(const OCRStudioSDKMultiPageReader&) = delete;
+
+  /// Destructor, stops background decoding and releases unread pages
+  ~OCRStudioSDKMultiPageReader() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    for (size_t i = 0; i < threads_.size(); ++i)
+      threads_[i].join();
+    // Pages not started are abandoned, their futures report a broken promise
+    tasks_.clear();
+    for (size_t i = 0; i < pending_.size(); ++i) {
+      try {
+        delete pending_[i].get();
+      } catch (...) {
+      }
+    }
+  }
+
+  /// Maximum number of background decoding threads of a reader
+  static const int kMaxDecodeThreads = 4;
+
+  /// Returns the number of pages in the file
+  int PagesCount() const {
+    return pages_count_;
+  }
+
+  /// Returns true iff there are pages not yet returned by Next()
+  bool HasNext() const {
+    return next_page_ < pages_count_;
+  }
+
+  /**
+   * @brief Returns the next page and schedules decoding of the following ones
+   * @return Pointer to the decoded page image, the ownership is relinquished.
+   */
+  OCRStudioSDKImage* Next() {
+    if (!HasNext()) {
+      throw OCRStudioSDKException(
+          "InvalidStateException", "All pages have already been read");
+    }
+    SchedulePrefetch();
+    std::future<OCRStudioSDKImage*> page = std::move(pending_.front());
+    pending_.pop_front();
+    ++next_page_;
+    SchedulePrefetch();
+    return page.get();
+  }
+
+  /**
+   * @brief Decodes an arbitrary page synchronously, independently of Next()
+   * @param page_number - page number, starting with 0
+   * @return Pointer to the decoded page image, the ownership is relinquished.
+   */
+  OCRStudioSDKImage* DecodePage(int page_number) const {
+    return OCRStudioSDKImage::CreateFromFileBuffer(
+        const_cast<unsigned char*>(data_.data()), static_cast<int>(data_.size()),
+        page_number, max_width_, max_height_);
+  }
+
+private:
+  /// Page queued for background decoding
+  struct DecodeTask {
+    int page_number;                          ///< page to decode
+    std::promise<OCRStudioSDKImage*> result;  ///< decoded page or error
+  };
+
+  /// Queues background decoding of pages up to the prefetch depth, starting
+  /// decoding threads as needed
+  void SchedulePrefetch() {
+    while (next_scheduled_page_ < pages_count_ &&
+           static_cast<int>(pending_.size()) < prefetch_depth_) {
+      // A page is queued only once a thread exists to decode it
+      if (static_cast<int>(threads_.size()) < max_threads_ &&
+          static_cast<int>(threads_.size()) <= static_cast<int>(pending_.size()))
+        threads_.push_back(std::thread(&OCRStudioSDKMultiPageReader::RunWorker, this));
+      DecodeTask task;
+      task.page_number = next_scheduled_page_;
+      pending_.push_back(task.result.get_future());
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+      }
+      queue_cv_.notify_one();
+      ++next_scheduled_page_;
+    }
+  }
+
+  /// Decoding thread loop: decodes queued pages until stopped
+  void RunWorker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      queue_cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      if (stopping_)
+        break;
+      DecodeTask task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      try {
+        task.result.set_value(DecodePage(task.page_number));
+      } catch (...) {
+        task.result.set_exception(std::current_exception());
+      }
+      lock.lock();
+    }
+  }
+
+private:
+  std::vector<unsigned char> data_;  ///< contents of the file
+  int pages_count_;                  ///< number of pages
+  int prefetch_depth_;               ///< maximum number of pending pages
+  int max_threads_;                  ///< maximum number of decoding threads
+  const int max_width_;              ///< maximum page width
+  const int max_height_;             ///< maximum page height
+
+  int next_page_;                    ///< page returned by the next Next()
+  int next_scheduled_page_;          ///< next page to schedule for decoding
+  /// Pages being decoded, starting with next_page_
+  std::deque<std::future<OCRStudioSDKImage*> > pending_;
+  std::vector<std::thread> threads_; ///< decoding threads
+
+  std::mutex mutex_;                 ///< guards the fields below
+  std::condition_variable queue_cv_; ///< signals queued pages or stop
+  std::deque<DecodeTask> tasks_;     ///< pages queued for decoding
+  bool stopping_;                    ///< destructor was called
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_MULTIPAGE_READER_H_INCLUDED
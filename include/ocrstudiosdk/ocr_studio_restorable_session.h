@@ -0,0 +1,334 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_restorable_session.h
+ * @brief Session wrapper whose state can be saved into a binary blob and
+ *        restored in another process (header-only, built on top of the
+ *        public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_RESTORABLE_SESSION_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_RESTORABLE_SESSION_H_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_session.h>
+#include <ocrstudiosdk/ocr_studio_image.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_hash.h>
+#include <ocrstudiosdk/ocr_studio_image_ops.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Session wrapper which keeps a journal of the inputs processed since
+ *        creation or Reset(), so that the session state can leave the
+ *        process. The internal state of the engine is not accessible through
+ *        the public interface, so SaveState() serializes the journal and
+ *        RestoreState() replays it on a session created with the same
+ *        parameters, which brings it to the same state.
+ *
+ *        Saving is a copy of the journal. Restoring costs the processing of
+ *        the journaled frames, and the delegate of the wrapped session
+ *        receives their messages again. The journal holds an unpadded copy
+ *        of every frame, so the blob takes about width * height * channels
+ *        bytes per journaled frame (2.6 MiB for a 1280x720 RGB frame) plus
+ *        the data strings; the frames limit bounds it, at the price of
+ *        restored sessions having seen only the last frames. The journaled
+ *        images must have 8-bit channels, see PixelView().
+ *
+ *        Blob format, version 1, integers little-endian:
+ *          "OSSJ", u32 version, u32 params size, canonical session params,
+ *          u32 entries count, entries, u64 XXH64 of all preceding bytes;
+ *          image entry: u8 1, u32 width, u32 height, u32 channels, rows
+ *          without padding; data entry: u8 2, u32 size, data.
+ */
+class OCRStudioSDKRestorableSession : public OCRStudioSDKSession {
+public:
+  /// Version of the blob format written by SaveState()
+  static const uint32_t kStateFormatVersion = 1;
+
+  /**
+   * @brief Main constructor
+   * @param session - session to be wrapped, the ownership is taken
+   * @param json_session_params - parameters the session was created with,
+   *        checked by RestoreState()
+   * @param max_journal_frames - maximum number of journaled frames, the
+   *        oldest are dropped (0 for unlimited, so the journal grows with
+   *        every frame until Reset())
+   */
+  OCRStudioSDKRestorableSession(OCRStudioSDKSession* session,
+                                const char*          json_session_params,
+                                int                  max_journal_frames)
+    : session_(session),
+      session_params_(detail::CanonicalJSON(json_session_params)),
+      max_journal_frames_(max_journal_frames),
+      journal_frames_(0),
+      journal_bytes_(0) {}
+
+  /// Returns the number of journaled frames
+  int JournalFrames() const {
+    return journal_frames_;
+  }
+
+  /// Returns the size of the journaled inputs in bytes
+  size_t JournalBytes() const {
+    return journal_bytes_;
+  }
+
+  /// Returns the wrapped session
+  OCRStudioSDKSession& Session() {
+    return *session_;
+  }
+
+  /**
+   * @brief Serializes the session state
+   * @return Versioned binary blob, see the class comment
+   */
+  std::vector<unsigned char> SaveState() const {
+    std::vector<unsigned char> blob;
+    blob.reserve(journal_bytes_ + session_params_.size() + 32 + 16 * journal_.size());
+    blob.insert(blob.end(), Magic(), Magic() + 4);
+    AppendU32(blob, kStateFormatVersion);
+    AppendU32(blob, static_cast<uint32_t>(session_params_.size()));
+    blob.insert(blob.end(), session_params_.begin(), session_params_.end());
+    AppendU32(blob, static_cast<uint32_t>(journal_.size()));
+    for (JournalEntries::const_iterator it = journal_.begin(); it != journal_.end(); ++it) {
+      blob.push_back(static_cast<unsigned char>(it->kind));
+      if (it->kind == kImageEntry) {
+        AppendU32(blob, static_cast<uint32_t>(it->width));
+        AppendU32(blob, static_cast<uint32_t>(it->height));
+        AppendU32(blob, static_cast<uint32_t>(it->channels));
+      } else {
+        AppendU32(blob, static_cast<uint32_t>(it->data.size()));
+      }
+      blob.insert(blob.end(), it->data.begin(), it->data.end());
+    }
+    const uint64_t checksum = detail::HashBytes(blob.data(), blob.size());
+    for (int i = 0; i < 8; ++i)
+      blob.push_back(static_cast<unsigned char>(checksum >> (8 * i)));
+    return blob;
+  }
+
+  /**
+   * @brief Resets the session and brings it to the saved state by replaying
+   *        the saved inputs. The blob is validated before the session is
+   *        modified; if the replay throws, the session keeps the inputs
+   *        replayed so far.
+   * @param blob - pointer to a blob produced by SaveState()
+   * @param blob_size - size of the blob in bytes
+   */
+  void RestoreState(const unsigned char* blob, size_t blob_size) {
+    JournalEntries journal;
+    Parse(blob, blob_size, journal);
+
+    session_->Reset();
+    ClearJournal();
+    std::vector<unsigned char> data_str;
+    for (JournalEntries::iterator it = journal.begin(); it != journal.end(); ++it) {
+      if (it->kind == kImageEntry) {
+        const int bytes_per_line = it->width * it->channels;
+        std::unique_ptr<OCRStudioSDKImage> image(OCRStudioSDKImage::CreateFromBuffer(
+            it->data.data(), static_cast<int>(it->data.size()),
+            it->width, it->height, bytes_per_line, it->channels));
+        session_->ProcessImage(*image);
+      } else {
+        data_str.assign(it->data.begin(), it->data.end());
+        data_str.push_back('\0');
+        session_->ProcessData(reinterpret_cast<const char*>(data_str.data()));
+      }
+      AddToJournal(*it);
+    }
+  }
+
+  /// Convenience overload of RestoreState() for a vector
+  void RestoreState(const std::vector<unsigned char>& blob) {
+    RestoreState(blob.data(), blob.size());
+  }
+
+  virtual const char* Description() const override {
+    return session_->Description();
+  }
+
+  virtual void ProcessImage(const OCRStudioSDKImage& image) override {
+    const OCRStudioSDKPixelView view = PixelView(image);
+    JournalEntry entry;
+    entry.kind = kImageEntry;
+    entry.width = view.width;
+    entry.height = view.height;
+    entry.channels = view.channels;
+    const size_t row_size = static_cast<size_t>(view.width) * view.channels;
+    entry.data.resize(row_size * view.height);
+    for (int y = 0; y < view.height; ++y) {
+      std::memcpy(&entry.data[row_size * y],
+                  view.data + static_cast<ptrdiff_t>(y) * view.bytes_per_line, row_size);
+    }
+    session_->ProcessImage(image);
+    AddToJournal(entry);
+  }
+
+  virtual void ProcessData(const char* data_str) override {
+    session_->ProcessData(data_str);
+    JournalEntry entry;
+    entry.kind = kDataEntry;
+    entry.width = entry.height = entry.channels = 0;
+    entry.data.assign(data_str, data_str + std::strlen(data_str));
+    AddToJournal(entry);
+  }
+
+  virtual const OCRStudioSDKResult& CurrentResult() const override {
+    return session_->CurrentResult();
+  }
+
+  virtual void Reset() override {
+    session_->Reset();
+    ClearJournal();
+  }
+
+  virtual void Suspend() override {
+    session_->Suspend();
+  }
+
+  virtual void Resume() override {
+    session_->Resume();
+  }
+
+private:
+  enum EntryKind {
+    kImageEntry = 1,
+    kDataEntry = 2
+  };
+
+  /// Journaled input
+  struct JournalEntry {
+    EntryKind kind;                   ///< input kind
+    int width;                        ///< image width
+    int height;                       ///< image height
+    int channels;                     ///< image channels
+    std::vector<unsigned char> data;  ///< image rows or data string
+  };
+
+  typedef std::deque<JournalEntry> JournalEntries;
+
+  static const char* Magic() {
+    return "OSSJ";
+  }
+
+  static void AppendU32(std::vector<unsigned char>& blob, uint32_t value) {
+    for (int i = 0; i < 4; ++i)
+      blob.push_back(static_cast<unsigned char>(value >> (8 * i)));
+  }
+
+  /// Reads a blob into journal entries, throwing on malformed blobs
+  void Parse(const unsigned char* blob, size_t blob_size, JournalEntries& journal) const {
+    if (!blob || blob_size < 20 || std::memcmp(blob, Magic(), 4) != 0)
+      ThrowInvalidArgument("not a session state");
+    const size_t body_size = blob_size - 8;
+    uint64_t checksum = 0;
+    for (int i = 7; i >= 0; --i)
+      checksum = (checksum << 8) | blob[body_size + i];
+    if (checksum != detail::HashBytes(blob, body_size))
+      ThrowInvalidArgument("checksum mismatch");
+
+    size_t pos = 4;
+    const uint32_t version = ReadU32(blob, body_size, pos);
+    if (version != kStateFormatVersion)
+      ThrowInvalidArgument("unsupported version " + std::to_string(version));
+    const uint32_t params_size = ReadU32(blob, body_size, pos);
+    if (params_size > body_size - pos ||
+        session_params_.compare(0, std::string::npos,
+                                reinterpret_cast<const char*>(blob + pos), params_size) != 0)
+      ThrowInvalidArgument("saved with different session parameters");
+    pos += params_size;
+
+    const uint32_t entries_count = ReadU32(blob, body_size, pos);
+    for (uint32_t i = 0; i < entries_count; ++i) {
+      if (pos >= body_size)
+        ThrowInvalidArgument("truncated");
+      JournalEntry entry;
+      entry.kind = static_cast<EntryKind>(blob[pos++]);
+      uint64_t data_size;
+      if (entry.kind == kImageEntry) {
+        entry.width = static_cast<int>(ReadU32(blob, body_size, pos));
+        entry.height = static_cast<int>(ReadU32(blob, body_size, pos));
+        entry.channels = static_cast<int>(ReadU32(blob, body_size, pos));
+        const uint64_t row_size = static_cast<uint64_t>(entry.width) * entry.channels;
+        if (entry.width <= 0 || entry.height <= 0 || entry.channels <= 0 ||
+            row_size > body_size - pos ||
+            static_cast<uint64_t>(entry.height) > (body_size - pos) / row_size)
+          ThrowInvalidArgument("invalid image size");
+        data_size = row_size * entry.height;
+      } else if (entry.kind == kDataEntry) {
+        entry.width = entry.height = entry.channels = 0;
+        data_size = ReadU32(blob, body_size, pos);
+      } else {
+        ThrowInvalidArgument("unknown entry");
+      }
+      if (data_size > body_size - pos)
+        ThrowInvalidArgument("truncated");
+      entry.data.assign(blob + pos, blob + pos + data_size);
+      pos += static_cast<size_t>(data_size);
+      journal.push_back(std::move(entry));
+    }
+    if (pos != body_size)
+      ThrowInvalidArgument("trailing bytes");
+  }
+
+  static uint32_t ReadU32(const unsigned char* blob, size_t size, size_t& pos) {
+    if (size - pos < 4)
+      ThrowInvalidArgument("truncated");
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i)
+      value = (value << 8) | blob[pos + i];
+    pos += 4;
+    return value;
+  }
+
+  static void ThrowInvalidArgument(const std::string& reason) {
+    throw OCRStudioSDKException(
+        "InvalidArgumentException", ("Cannot restore session state: " + reason).c_str());
+  }
+
+  void AddToJournal(JournalEntry& entry) {
+    journal_bytes_ += entry.data.size();
+    if (entry.kind == kImageEntry)
+      ++journal_frames_;
+    journal_.push_back(std::move(entry));
+    // The oldest inputs are dropped up to and including the oldest frame
+    while (max_journal_frames_ > 0 && journal_frames_ > max_journal_frames_) {
+      if (journal_.front().kind == kImageEntry)
+        --journal_frames_;
+      journal_bytes_ -= journal_.front().data.size();
+      journal_.pop_front();
+    }
+  }
+
+  void ClearJournal() {
+    journal_.clear();
+    journal_frames_ = 0;
+    journal_bytes_ = 0;
+  }
+
+private:
+  std::unique_ptr<OCRStudioSDKSession> session_;  ///< wrapped session
+  const std::string session_params_;      ///< canonical session parameters
+  const int max_journal_frames_;          ///< journaled frames limit, or 0
+  JournalEntries journal_;                ///< inputs since the last reset
+  int journal_frames_;                    ///< journaled frames
+  size_t journal_bytes_;                  ///< journaled input bytes
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_RESTORABLE_SESSION_H_INCLUDED
@@ -0,0 +1,306 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_result_cache.h
+ * @brief Content-addressed LRU cache of recognition results for duplicate
+ *        images (header-only, built on top of the public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_RESULT_CACHE_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_RESULT_CACHE_H_INCLUDED
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_instance.h>
+#include <ocrstudiosdk/ocr_studio_session.h>
+#include <ocrstudiosdk/ocr_studio_result.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_hash.h>
+#include <ocrstudiosdk/ocr_studio_image_ops.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Counters of a result cache
+ */
+struct OCRStudioSDKResultCacheStats {
+  long long hits;       ///< Lookups served from the cache
+  long long misses;     ///< Lookups not found in the cache
+  long long insertions; ///< Results added to the cache
+  long long evictions;  ///< Results evicted to respect the bounds
+  int       entries;    ///< Results currently cached
+  long long bytes;      ///< Estimated size of the cached results
+};
+
+
+
+/**
+ * @brief Thread-safe LRU cache of final results keyed by the content of the
+ *        image and the canonical session parameters, for services receiving
+ *        the same images several times (retries, re-uploads, re-processing).
+ *        A hit costs hashing the pixels and a map lookup instead of a
+ *        recognition.
+ *
+ *        A cache belongs to one engine instance: keys identify the image and
+ *        the session parameters, but not the instance or its configuration,
+ *        so results of sessions of other instances must not be cached in it.
+ *        Images are identified by a 64-bit hash of their size and pixels, so
+ *        the cache must not be used where images may be crafted to collide.
+ *        The size of a result is estimated from its strings and images.
+ */
+class OCRStudioSDKResultCache {
+public:
+  /**
+   * @brief Main constructor
+   * @param instance - the instance whose sessions produce all the cached
+   *        results, must outlive the cache
+   * @param max_bytes - bound of the estimated size of the cached results
+   * @param max_entries - bound of the number of cached results (0 for
+   *        unlimited)
+   */
+  explicit OCRStudioSDKResultCache(const OCRStudioSDKInstance& instance,
+                                   long long                   max_bytes = 64LL << 20,
+                                   int                         max_entries = 0)
+    : instance_(instance),
+      max_bytes_(max_bytes),
+      max_entries_(max_entries),
+      bytes_(0) {
+    stats_.hits = 0;
+    stats_.misses = 0;
+    stats_.insertions = 0;
+    stats_.evictions = 0;
+    stats_.entries = 0;
+    stats_.bytes = 0;
+  }
+
+  /// Non-copyable
+  OCRStudioSDKResultCache(const OCRStudioSDKResultCache&) = delete;
+  OCRStudioSDKResultCache& operator =(const OCRStudioSDKResultCache&) = delete;
+
+  /// Returns the instance the cache belongs to
+  const OCRStudioSDKInstance& Instance() const {
+    return instance_;
+  }
+
+  /**
+   * @brief Computes the cache key of an image processed with the given
+   *        session parameters
+   * @param image - the image, with 8-bit channels (see PixelView())
+   * @param json_session_params - session parameters, compared in canonical
+   *        form, see OCRStudioSDKInstance::CreateSession()
+   * @return Cache key
+   */
+  static std::string Key(const OCRStudioSDKImage& image,
+                         const char*              json_session_params) {
+    const OCRStudioSDKPixelView view = PixelView(image);
+    detail::ContentHasher hasher;
+    hasher.UpdateValue(view.width);
+    hasher.UpdateValue(view.height);
+    hasher.UpdateValue(view.channels);
+    const size_t row_size = static_cast<size_t>(view.width) * view.channels;
+    for (int y = 0; y < view.height; ++y)
+      hasher.Update(view.data + static_cast<ptrdiff_t>(y) * view.bytes_per_line, row_size);
+
+    char hash_str[17];
+    std::snprintf(hash_str, sizeof(hash_str), "%016llx",
+                  static_cast<unsigned long long>(hasher.Digest()));
+    std::string key(hash_str);
+    key += ':';
+    key += detail::CanonicalJSON(json_session_params);
+    return key;
+  }
+
+  /**
+   * @brief Looks up a result
+   * @param key - cache key, see Key()
+   * @return Cached result, or null. The result stays valid after eviction.
+   */
+  std::shared_ptr<const OCRStudioSDKResult> Find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const EntryMap::iterator it = entries_.find(key);
+    if (it == entries_.end()) {
+      ++stats_.misses;
+      return std::shared_ptr<const OCRStudioSDKResult>();
+    }
+    ++stats_.hits;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->result;
+  }
+
+  /**
+   * @brief Adds a deep copy of a result, evicting the least recently used
+   *        results over the bounds. Results larger than the bytes bound are
+   *        not cached.
+   * @param key - cache key, see Key()
+   * @param result - the result to be copied
+   * @return The cached copy
+   */
+  std::shared_ptr<const OCRStudioSDKResult> Insert(const std::string&        key,
+                                                   const OCRStudioSDKResult& result) {
+    // The copy and its size estimate are made outside of the lock
+    std::shared_ptr<const OCRStudioSDKResult> copy(result.DeepCopy());
+    const long long size = EstimateSize(*copy) + static_cast<long long>(2 * key.size());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const EntryMap::iterator it = entries_.find(key);
+    if (it != entries_.end())
+      Erase(it);
+    if (size > max_bytes_)
+      return copy;
+    lru_.push_front(Entry());
+    lru_.front().key = key;
+    lru_.front().result = copy;
+    lru_.front().size = size;
+    entries_[key] = lru_.begin();
+    bytes_ += size;
+    ++stats_.insertions;
+    while (bytes_ > max_bytes_ ||
+           (max_entries_ > 0 && static_cast<int>(entries_.size()) > max_entries_)) {
+      Erase(entries_.find(lru_.back().key));
+      ++stats_.evictions;
+    }
+    return copy;
+  }
+
+  /**
+   * @brief Returns the cached result of an image, or processes the image
+   *        with the session and caches the result. The session is reset
+   *        before processing.
+   * @param session - session of the cache instance, which must have been
+   *        created with json_session_params: the result is cached under
+   *        these parameters, whatever the session was created with
+   * @param json_session_params - parameters the session was created with
+   * @param image - the image, with 8-bit channels (see PixelView())
+   * @return The result, cached or new
+   */
+  std::shared_ptr<const OCRStudioSDKResult> ProcessImage(
+      OCRStudioSDKSession&     session,
+      const char*              json_session_params,
+      const OCRStudioSDKImage& image) {
+    const std::string key = Key(image, json_session_params);
+    std::shared_ptr<const OCRStudioSDKResult> result = Find(key);
+    if (result)
+      return result;
+    session.Reset();
+    session.ProcessImage(image);
+    return Insert(key, session.CurrentResult());
+  }
+
+  /**
+   * @brief Returns the cached result of an image, or processes the image
+   *        with a new session of the cache instance and caches the result.
+   *        The session is only created on a miss, so the result always
+   *        matches the parameters it is cached under.
+   * @param authorization_signature - signature for the session creation,
+   *        see OCRStudioSDKInstance::CreateSession()
+   * @param json_session_params - parameters of the session
+   * @param image - the image, with 8-bit channels (see PixelView())
+   * @return The result, cached or new
+   */
+  std::shared_ptr<const OCRStudioSDKResult> ProcessImage(
+      const char*              authorization_signature,
+      const char*              json_session_params,
+      const OCRStudioSDKImage& image) {
+    const std::string key = Key(image, json_session_params);
+    std::shared_ptr<const OCRStudioSDKResult> result = Find(key);
+    if (result)
+      return result;
+    std::unique_ptr<OCRStudioSDKSession> session(
+        instance_.CreateSession(authorization_signature, json_session_params));
+    session->ProcessImage(image);
+    return Insert(key, session->CurrentResult());
+  }
+
+  /// Removes all cached results
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    lru_.clear();
+    bytes_ = 0;
+  }
+
+  /// Returns the counters of the cache
+  OCRStudioSDKResultCacheStats Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    OCRStudioSDKResultCacheStats stats = stats_;
+    stats.entries = static_cast<int>(entries_.size());
+    stats.bytes = bytes_;
+    return stats;
+  }
+
+  /**
+   * @brief Estimates the memory taken by a result: its strings, item
+   *        images and a fixed overhead per object
+   */
+  static long long EstimateSize(const OCRStudioSDKResult& result) {
+    const long long kObjectOverhead = 256;
+    long long size = kObjectOverhead;
+    std::vector<std::string> item_types;
+    for (int target_index = 0; target_index < result.TargetsCount(); ++target_index) {
+      const OCRStudioSDKTarget& target = result.TargetByIndex(target_index);
+      size += kObjectOverhead + static_cast<long long>(std::strlen(target.Description()));
+      detail::ExtractJSONStringArray(target.Description(), "item_types", item_types);
+      for (size_t i = 0; i < item_types.size(); ++i) {
+        const char* item_type = item_types[i].c_str();
+        for (OCRStudioSDKItemIterator it = target.ItemsBegin(item_type),
+             end = target.ItemsEnd(item_type); it != end; it.Step()) {
+          const OCRStudioSDKItem& item = it.Item();
+          size += kObjectOverhead +
+              static_cast<long long>(std::strlen(item.Name()) + std::strlen(item.Value()) +
+                                     std::strlen(item.Attributes()) +
+                                     std::strlen(item.Description()));
+          if (item.HasImage()) {
+            const OCRStudioSDKImage& item_image = item.Image();
+            size += static_cast<long long>(item_image.BytesPerLine()) * item_image.Height();
+          }
+        }
+      }
+    }
+    return size;
+  }
+
+private:
+  /// Cached result
+  struct Entry {
+    std::string key;                                   ///< cache key
+    std::shared_ptr<const OCRStudioSDKResult> result;  ///< cached copy
+    long long size;                                    ///< estimated size
+  };
+
+  typedef std::list<Entry> EntryList;
+  typedef std::unordered_map<std::string, EntryList::iterator> EntryMap;
+
+  void Erase(EntryMap::iterator it) {
+    bytes_ -= it->second->size;
+    lru_.erase(it->second);
+    entries_.erase(it);
+  }
+
+private:
+  const OCRStudioSDKInstance& instance_;  ///< instance of the results
+  const long long max_bytes_;             ///< bound of the cached bytes
+  const int max_entries_;                 ///< bound of the entries, or 0
+
+  mutable std::mutex mutex_;              ///< guards the fields below
+  EntryList lru_;                         ///< entries, most recent first
+  EntryMap entries_;                      ///< entries by key
+  long long bytes_;                       ///< estimated size of the entries
+  OCRStudioSDKResultCacheStats stats_;    ///< cumulative counters
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_RESULT_CACHE_H_INCLUDED
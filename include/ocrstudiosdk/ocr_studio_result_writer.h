@@ -0,0 +1,289 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_result_writer.h
+ * @brief Streaming serialization of results into a caller-provided sink
+ *        (header-only, built on top of the public result interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_RESULT_WRITER_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_RESULT_WRITER_H_INCLUDED
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_result.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Output sink interface receiving serialized data in chunks
+ */
+class OCRStudioSDKOutputSink {
+public:
+  /// Virtual destructor
+  virtual ~OCRStudioSDKOutputSink() = default;
+
+  /**
+   * @brief Receives the next chunk of serialized data
+   * @param data - pointer to the chunk (valid only during the call)
+   * @param size - size of the chunk in bytes
+   */
+  virtual void Write(const char* data, size_t size) = 0;
+};
+
+
+
+/**
+ * @brief Output sink appending the data to a std::string
+ */
+class OCRStudioSDKStringSink : public OCRStudioSDKOutputSink {
+public:
+  /// Main constructor, the string must outlive the sink
+  explicit OCRStudioSDKStringSink(std::string& out)
+    : out_(out) {}
+
+  virtual void Write(const char* data, size_t size) override {
+    out_.append(data, size);
+  }
+
+private:
+  std::string& out_;  ///< output string
+};
+
+
+
+/**
+ * @brief Output sink writing the data to a stdio stream
+ */
+class OCRStudioSDKFileSink : public OCRStudioSDKOutputSink {
+public:
+  /// Main constructor, the stream is not closed by the sink
+  explicit OCRStudioSDKFileSink(std::FILE* file)
+    : file_(file) {}
+
+  virtual void Write(const char* data, size_t size) override {
+    if (std::fwrite(data, 1, size, file_) != size)
+      throw OCRStudioSDKException("FileSystemException", "Output write failed");
+  }
+
+private:
+  std::FILE* file_;  ///< output stream
+};
+
+
+
+/**
+ * @brief Serialization mode for item images
+ */
+enum OCRStudioSDKImageSerialization {
+  OCRSTUDIOSDK_IMAGES_INLINE = 0,  ///< Base64 JPEG in the "image" member
+  OCRSTUDIOSDK_IMAGES_REFERENCE,   ///< Reference in the "image_ref" member
+  OCRSTUDIOSDK_IMAGES_EXCLUDE      ///< Images are omitted
+};
+
+
+
+/**
+ * @brief Serializes a result to JSON, streaming it into a sink through a
+ *        small fixed-size buffer, so no string holding the whole result is
+ *        built. Inline images are written one at a time, so the peak memory
+ *        is bounded by the largest single image rather than by the result.
+ *
+ *        The output has the following format:
+ *        {
+ *          "targets": [
+ *            {
+ *              "description": { (OCRStudioSDKTarget::Description()) },
+ *              "is_final": (bool),
+ *              "items": {
+ *                "(item_type)": [
+ *                  {
+ *                    "name": "(item_name)",
+ *                    "value": "(item_value)",
+ *                    "confidence": (double),
+ *                    "accepted": (bool),
+ *                    "attributes": { (OCRStudioSDKItem::Attributes()) },
+ *                    "description": { (OCRStudioSDKItem::Description()) },
+ *                    "image": "(base64 JPEG)",          // inline mode
+ *                    "image_ref": "(target_index)/(item_type)/(item_name)"
+ *                                                       // reference mode
+ *                  },
+ *                  ...
+ *                ],
+ *                ...
+ *              }
+ *            },
+ *            ...
+ *          ],
+ *          "all_targets_final": (bool)
+ *        }
+ *        In reference mode the image of an item can be obtained from the
+ *        result with TargetByIndex(target_index).Item(item_type, item_name).
+ */
+class OCRStudioSDKResultWriter {
+public:
+  /**
+   * @brief Main constructor
+   * @param sink - output sink, must outlive the writer
+   * @param images - serialization mode for item images
+   * @param buffer_size - size of the internal buffer in bytes
+   */
+  explicit OCRStudioSDKResultWriter(
+      OCRStudioSDKOutputSink&        sink,
+      OCRStudioSDKImageSerialization images = OCRSTUDIOSDK_IMAGES_INLINE,
+      size_t                         buffer_size = 16384)
+    : sink_(sink),
+      images_(images),
+      buffer_capacity_(buffer_size > 256 ? buffer_size : 256) {
+    buffer_.reserve(buffer_capacity_);
+  }
+
+  /**
+   * @brief Serializes a result into the sink
+   * @param result - the result to be serialized
+   */
+  void Write(const OCRStudioSDKResult& result) {
+    Append("{\"targets\": [");
+    std::vector<std::string> item_types;
+    for (int target_index = 0; target_index < result.TargetsCount(); ++target_index) {
+      const OCRStudioSDKTarget& target = result.TargetByIndex(target_index);
+      if (target_index > 0)
+        Append(", ");
+      Append("{\"description\": ");
+      AppendRaw(target.Description());
+      Append(", \"is_final\": ");
+      Append(target.IsFinal() ? "true" : "false");
+      Append(", \"items\": {");
+      detail::ExtractJSONStringArray(target.Description(), "item_types", item_types);
+      for (size_t type_index = 0; type_index < item_types.size(); ++type_index) {
+        if (type_index > 0)
+          Append(", ");
+        WriteItems(target, target_index, item_types[type_index]);
+      }
+      Append("}}");
+    }
+    Append("], \"all_targets_final\": ");
+    Append(result.AllTargetsFinal() ? "true" : "false");
+    Append("}");
+    Flush();
+  }
+
+private:
+  /// Serializes the items of a target with the given type
+  void WriteItems(const OCRStudioSDKTarget& target, int target_index,
+                  const std::string& item_type) {
+    scratch_.clear();
+    detail::AppendJSONString(scratch_, item_type.c_str());
+    scratch_ += ": [";
+    Append(scratch_);
+    bool first = true;
+    for (OCRStudioSDKItemIterator it = target.ItemsBegin(item_type.c_str()),
+         end = target.ItemsEnd(item_type.c_str()); it != end; it.Step()) {
+      const OCRStudioSDKItem& item = it.Item();
+      if (!first)
+        Append(", ");
+      first = false;
+
+      scratch_ = "{\"name\": ";
+      detail::AppendJSONString(scratch_, item.Name());
+      scratch_ += ", \"value\": ";
+      detail::AppendJSONString(scratch_, item.Value());
+      scratch_ += ", \"confidence\": ";
+      detail::AppendJSONNumber(scratch_, item.Confidence());
+      scratch_ += ", \"accepted\": ";
+      scratch_ += item.Accepted() ? "true" : "false";
+      Append(scratch_);
+      Append(", \"attributes\": ");
+      AppendRaw(item.Attributes());
+      Append(", \"description\": ");
+      AppendRaw(item.Description());
+
+      if (item.HasImage() && images_ == OCRSTUDIOSDK_IMAGES_INLINE) {
+        Append(", \"image\": \"");
+        const OCRStudioSDKString base64 = item.Image().ExportBase64JPEG();
+        Append(base64.CStr(), static_cast<size_t>(base64.Size()));
+        Append("\"");
+      } else if (item.HasImage() && images_ == OCRSTUDIOSDK_IMAGES_REFERENCE) {
+        std::string reference;
+        detail::AppendJSONNumber(reference, static_cast<long long>(target_index));
+        reference += "/" + item_type + "/" + item.Name();
+        scratch_ = ", \"image_ref\": ";
+        detail::AppendJSONString(scratch_, reference.c_str());
+        Append(scratch_);
+      }
+      Append("}");
+    }
+    Append("]");
+  }
+
+  /// Appends an embedded JSON document, or null if it is empty
+  void AppendRaw(const char* json) {
+    if (!json || !*json)
+      Append("null");
+    else
+      Append(json, std::strlen(json));
+  }
+
+  void Append(const char* data) {
+    Append(data, std::strlen(data));
+  }
+
+  void Append(const std::string& data) {
+    Append(data.data(), data.size());
+  }
+
+  /// Appends data to the buffer, large chunks bypass the buffer
+  void Append(const char* data, size_t size) {
+    if (buffer_.size() + size > buffer_capacity_) {
+      Flush();
+      if (size >= buffer_capacity_) {
+        sink_.Write(data, size);
+        return;
+      }
+    }
+    buffer_.append(data, size);
+  }
+
+  /// Passes the buffered data to the sink
+  void Flush() {
+    if (!buffer_.empty()) {
+      sink_.Write(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+  }
+
+private:
+  OCRStudioSDKOutputSink& sink_;            ///< output sink
+  OCRStudioSDKImageSerialization images_;   ///< image serialization mode
+  const size_t buffer_capacity_;            ///< flush threshold in bytes
+  std::string buffer_;                      ///< pending output
+  std::string scratch_;                     ///< reused formatting buffer
+};
+
+
+
+/**
+ * @brief Serializes a result to JSON into a sink, see OCRStudioSDKResultWriter
+ * @param result - the result to be serialized
+ * @param sink - output sink
+ * @param images - serialization mode for item images
+ */
+inline void SerializeTo(
+    const OCRStudioSDKResult&      result,
+    OCRStudioSDKOutputSink&        sink,
+    OCRStudioSDKImageSerialization images = OCRSTUDIOSDK_IMAGES_INLINE) {
+  OCRStudioSDKResultWriter(sink, images).Write(result);
+}
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_RESULT_WRITER_H_INCLUDED
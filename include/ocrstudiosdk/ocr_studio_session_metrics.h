@@ -0,0 +1,357 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_session_metrics.h
+ * @brief Session wrapper measuring the wall and CPU time of session calls
+ *        (header-only, built on top of the public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_SESSION_METRICS_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_SESSION_METRICS_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <ocrstudiosdk/ocr_studio_instance.h>
+#include <ocrstudiosdk/ocr_studio_session.h>
+#include <ocrstudiosdk/ocr_studio_delegate.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Measured stages of a session
+ */
+enum OCRStudioSDKSessionStage {
+  OCRSTUDIOSDK_STAGE_PROCESS_IMAGE = 0,  ///< ProcessImage() calls
+  OCRSTUDIOSDK_STAGE_PROCESS_DATA,       ///< ProcessData() calls
+  OCRSTUDIOSDK_STAGE_CURRENT_RESULT,     ///< CurrentResult() calls
+  OCRSTUDIOSDK_STAGE_RESET,              ///< Reset() calls
+  OCRSTUDIOSDK_STAGE_FEEDBACK,           ///< Feedback delegate callbacks, made
+                                         ///< from within the processing calls
+  OCRSTUDIOSDK_STAGES_COUNT
+};
+
+/**
+ * @brief Timings of a session stage
+ */
+struct OCRStudioSDKStageMetrics {
+  long long count;   ///< Number of invocations
+  long long errors;  ///< Number of invocations which have thrown
+  double wall_ms;    ///< Wall time in milliseconds
+  double cpu_ms;     ///< CPU time of the calling thread in milliseconds
+};
+
+/**
+ * @brief Timings of all stages of a session, for the last processing call
+ *        (ProcessImage() or ProcessData()) and accumulated since creation or
+ *        ResetMetrics()
+ */
+struct OCRStudioSDKSessionMetrics {
+  /// Stages of the last processing call, including the feedback callbacks
+  /// made from it; the other stages count their last invocation
+  OCRStudioSDKStageMetrics last[OCRSTUDIOSDK_STAGES_COUNT];
+  /// Accumulated stages
+  OCRStudioSDKStageMetrics total[OCRSTUDIOSDK_STAGES_COUNT];
+};
+
+namespace detail {
+
+/// Returns the CPU time consumed by the calling thread, in milliseconds
+inline double ThreadCPUTimeMs() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif // CLOCK_THREAD_CPUTIME_ID
+  return 0.0;
+}
+
+inline const char* SessionStageName(int stage) {
+  static const char* const names[OCRSTUDIOSDK_STAGES_COUNT] = {
+      "process_image", "process_data", "current_result", "reset", "feedback"};
+  return names[stage];
+}
+
+inline void AppendStageMetrics(std::string& json, const OCRStudioSDKStageMetrics& m) {
+  json += "{\"count\": ";
+  AppendJSONNumber(json, m.count);
+  json += ", \"errors\": ";
+  AppendJSONNumber(json, m.errors);
+  json += ", \"wall_ms\": ";
+  AppendJSONNumber(json, m.wall_ms);
+  json += ", \"cpu_ms\": ";
+  AppendJSONNumber(json, m.cpu_ms);
+  json += "}";
+}
+
+} // namespace detail
+
+
+
+/**
+ * @brief Session wrapper measuring the wall time, the CPU time of the
+ *        calling thread and the number of invocations of the session calls.
+ *        When created with Create(), the time spent in the feedback delegate
+ *        is measured too, so the engine's own share of ProcessImage() is the
+ *        difference of the two.
+ *
+ *        The overhead is two clock readings and an uncontended lock per
+ *        call; with SetEnabled(false) calls are forwarded without any of it.
+ *        The wrapper is itself an OCRStudioSDKSession and can be passed
+ *        wherever a session is expected. Metrics() may be called from any
+ *        thread.
+ *
+ *        The engine's internal stages and threads are not visible through
+ *        the public interface, so the CPU time only covers the calling
+ *        thread.
+ */
+class OCRStudioSDKProfiledSession : public OCRStudioSDKSession {
+public:
+  /**
+   * @brief Creates a session wrapped for profiling, with the feedback
+   *        delegate measured as well
+   * @param instance - the configured engine instance
+   * @param authorization_signature - personalized signature
+   * @param json_session_params - session parameters in JSON format
+   * @param callback_delegate - optional feedback delegate, must outlive the
+   *        session
+   * @param enabled - whether the measurements are initially enabled
+   * @return Pointer to a new session, the ownership is relinquished.
+   */
+  static OCRStudioSDKProfiledSession* Create(
+      const OCRStudioSDKInstance& instance,
+      const char*                 authorization_signature,
+      const char*                 json_session_params,
+      OCRStudioSDKDelegate*       callback_delegate = nullptr,
+      bool                        enabled = true) {
+    std::unique_ptr<OCRStudioSDKProfiledSession> profiled(
+        new OCRStudioSDKProfiledSession(enabled));
+    profiled->feedback_.reset(new FeedbackDelegate(*profiled, callback_delegate));
+    profiled->session_.reset(instance.CreateSession(
+        authorization_signature, json_session_params, profiled->feedback_.get()));
+    return profiled.release();
+  }
+
+  /**
+   * @brief Wraps an existing session; the time spent in its feedback
+   *        delegate is not measured separately
+   * @param session - session to be wrapped, the ownership is taken
+   * @param enabled - whether the measurements are initially enabled
+   */
+  explicit OCRStudioSDKProfiledSession(OCRStudioSDKSession* session, bool enabled = true)
+    : OCRStudioSDKProfiledSession(enabled) {
+    session_.reset(session);
+  }
+
+  /// Enables or disables the measurements, may be called from any thread
+  void SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  /// Returns true iff the measurements are enabled
+  bool Enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the collected metrics
+  OCRStudioSDKSessionMetrics Metrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metrics_;
+  }
+
+  /**
+   * @brief Returns the collected metrics in JSON format:
+   *        {
+   *          "enabled": (bool),
+   *          "last": {
+   *            "(stage)": {"count": (int), "errors": (int),
+   *                        "wall_ms": (double), "cpu_ms": (double)},
+   *            ...
+   *          },
+   *          "total": { ... }
+   *        }
+   *        where (stage) is one of process_image, process_data,
+   *        current_result, reset, feedback.
+   */
+  std::string MetricsJSON() const {
+    const OCRStudioSDKSessionMetrics metrics = Metrics();
+    std::string json = "{\"enabled\": ";
+    json += Enabled() ? "true" : "false";
+    for (int part = 0; part < 2; ++part) {
+      json += part == 0 ? ", \"last\": {" : ", \"total\": {";
+      const OCRStudioSDKStageMetrics* stages = part == 0 ? metrics.last : metrics.total;
+      for (int stage = 0; stage < OCRSTUDIOSDK_STAGES_COUNT; ++stage) {
+        if (stage > 0)
+          json += ", ";
+        detail::AppendJSONString(json, detail::SessionStageName(stage));
+        json += ": ";
+        detail::AppendStageMetrics(json, stages[stage]);
+      }
+      json += "}";
+    }
+    json += "}";
+    return json;
+  }
+
+  /// Clears the collected metrics
+  void ResetMetrics() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_ = OCRStudioSDKSessionMetrics();
+  }
+
+  /// Returns the wrapped session
+  OCRStudioSDKSession& Session() {
+    return *session_;
+  }
+
+  virtual const char* Description() const override {
+    return session_->Description();
+  }
+
+  virtual void ProcessImage(const OCRStudioSDKImage& image) override {
+    if (!Enabled()) {
+      session_->ProcessImage(image);
+      return;
+    }
+    BeginProcessing();
+    Measurement measurement(*this, OCRSTUDIOSDK_STAGE_PROCESS_IMAGE);
+    session_->ProcessImage(image);
+    measurement.Succeeded();
+  }
+
+  virtual void ProcessData(const char* data_str) override {
+    if (!Enabled()) {
+      session_->ProcessData(data_str);
+      return;
+    }
+    BeginProcessing();
+    Measurement measurement(*this, OCRSTUDIOSDK_STAGE_PROCESS_DATA);
+    session_->ProcessData(data_str);
+    measurement.Succeeded();
+  }
+
+  virtual const OCRStudioSDKResult& CurrentResult() const override {
+    if (!Enabled())
+      return session_->CurrentResult();
+    Measurement measurement(*this, OCRSTUDIOSDK_STAGE_CURRENT_RESULT);
+    const OCRStudioSDKResult& result = session_->CurrentResult();
+    measurement.Succeeded();
+    return result;
+  }
+
+  virtual void Reset() override {
+    if (!Enabled()) {
+      session_->Reset();
+      return;
+    }
+    Measurement measurement(*this, OCRSTUDIOSDK_STAGE_RESET);
+    session_->Reset();
+    measurement.Succeeded();
+  }
+
+  virtual void Suspend() override {
+    session_->Suspend();
+  }
+
+  virtual void Resume() override {
+    session_->Resume();
+  }
+
+private:
+  /// Forwards feedback messages, measuring the time spent in the delegate
+  class FeedbackDelegate : public OCRStudioSDKDelegate {
+  public:
+    FeedbackDelegate(OCRStudioSDKProfiledSession& owner, OCRStudioSDKDelegate* delegate)
+      : owner_(owner), delegate_(delegate) {}
+
+    virtual void Callback(const char* json_message) override {
+      if (!owner_.Enabled()) {
+        if (delegate_)
+          delegate_->Callback(json_message);
+        return;
+      }
+      Measurement measurement(owner_, OCRSTUDIOSDK_STAGE_FEEDBACK);
+      if (delegate_)
+        delegate_->Callback(json_message);
+      measurement.Succeeded();
+    }
+
+  private:
+    OCRStudioSDKProfiledSession& owner_;  ///< profiled session
+    OCRStudioSDKDelegate* delegate_;      ///< user delegate, may be null
+  };
+
+  /// Measures a stage invocation from construction to destruction
+  class Measurement {
+  public:
+    Measurement(const OCRStudioSDKProfiledSession& owner, int stage)
+      : owner_(owner), stage_(stage), succeeded_(false),
+        wall_start_(std::chrono::steady_clock::now()),
+        cpu_start_(detail::ThreadCPUTimeMs()) {}
+
+    ~Measurement() {
+      const double wall_ms = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - wall_start_).count();
+      owner_.Record(stage_, wall_ms, detail::ThreadCPUTimeMs() - cpu_start_, succeeded_);
+    }
+
+    void Succeeded() {
+      succeeded_ = true;
+    }
+
+  private:
+    const OCRStudioSDKProfiledSession& owner_;
+    const int stage_;
+    bool succeeded_;
+    const std::chrono::steady_clock::time_point wall_start_;
+    const double cpu_start_;
+  };
+
+  explicit OCRStudioSDKProfiledSession(bool enabled)
+    : enabled_(enabled), metrics_() {}
+
+  /// Starts a processing call: the feedback stage of the last call is
+  /// accumulated over the callbacks made from it
+  void BeginProcessing() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_.last[OCRSTUDIOSDK_STAGE_FEEDBACK] = OCRStudioSDKStageMetrics();
+  }
+
+  void Record(int stage, double wall_ms, double cpu_ms, bool succeeded) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    OCRStudioSDKStageMetrics& last = metrics_.last[stage];
+    if (stage != OCRSTUDIOSDK_STAGE_FEEDBACK)
+      last = OCRStudioSDKStageMetrics();
+    OCRStudioSDKStageMetrics* const targets[2] = {&last, &metrics_.total[stage]};
+    for (int i = 0; i < 2; ++i) {
+      ++targets[i]->count;
+      if (!succeeded)
+        ++targets[i]->errors;
+      targets[i]->wall_ms += wall_ms;
+      targets[i]->cpu_ms += cpu_ms;
+    }
+  }
+
+private:
+  std::atomic<bool> enabled_;                       ///< measurements enabled
+  mutable std::mutex mutex_;                        ///< guards metrics_
+  mutable OCRStudioSDKSessionMetrics metrics_;      ///< collected metrics
+
+  // The delegate is declared before the session so that it outlives it
+  std::unique_ptr<FeedbackDelegate> feedback_;      ///< measuring delegate
+  std::unique_ptr<OCRStudioSDKSession> session_;    ///< wrapped session
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_SESSION_METRICS_H_INCLUDED
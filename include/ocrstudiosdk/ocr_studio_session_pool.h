@@ -0,0 +1,264 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_session_pool.h
+ * @brief Pool of pre-created sessions keyed by session parameters
+ *        (header-only, built on top of the public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_SESSION_POOL_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_SESSION_POOL_H_INCLUDED
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_instance.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Cumulative counters of a session pool
+ */
+struct OCRStudioSDKSessionPoolStats {
+  long long sessions_created;  ///< Sessions created by the pool
+  long long checkouts;         ///< Calls to Checkout()
+  long long checkout_hits;     ///< Checkouts served by an idle session
+  int       idle_sessions;     ///< Sessions currently idle in the pool
+  int       active_sessions;   ///< Sessions currently checked out
+};
+
+
+
+class OCRStudioSDKSessionPool;
+
+
+
+/**
+ * @brief Deleter of OCRStudioSDKPooledSession, returns the session to its
+ *        pool instead of destroying it
+ */
+struct OCRStudioSDKSessionReturner {
+  OCRStudioSDKSessionPool* pool;  ///< pool the session was checked out from
+
+  inline void operator ()(OCRStudioSDKSession* session) const;
+};
+
+/// Checked out session, returned to the pool when the handle is destroyed
+typedef std::unique_ptr<OCRStudioSDKSession, OCRStudioSDKSessionReturner>
+    OCRStudioSDKPooledSession;
+
+
+
+/**
+ * @brief Thread-safe pool of ready-to-use sessions. Idle sessions are kept
+ *        per session parameters; parameters are compared in a canonical JSON
+ *        form, so whitespace and key order differences do not matter.
+ *        Checked out sessions are reset when returned, so session creation
+ *        (parameter parsing, signature validation, internal state setup) is
+ *        taken off the request path once the pool is warm.
+ *
+ *        Pooled sessions are created without a callback delegate.
+ */
+class OCRStudioSDKSessionPool {
+public:
+  /**
+   * @brief Main constructor
+   * @param instance - engine instance, must outlive the pool
+   * @param authorization_signature - signature of an authorized SDK user
+   * @param max_idle_per_params - maximum number of idle sessions kept for
+   *        each distinct session parameters (0 for unlimited); returned
+   *        sessions exceeding the limit are destroyed
+   */
+  OCRStudioSDKSessionPool(
+      const OCRStudioSDKInstance& instance,
+      const char*                 authorization_signature,
+      int                         max_idle_per_params = 0)
+    : instance_(instance),
+      signature_(authorization_signature),
+      max_idle_per_params_(max_idle_per_params) {
+    stats_.sessions_created = 0;
+    stats_.checkouts = 0;
+    stats_.checkout_hits = 0;
+    stats_.idle_sessions = 0;
+    stats_.active_sessions = 0;
+  }
+
+  /// Destructor, destroys idle sessions. All sessions must be returned.
+  ~OCRStudioSDKSessionPool() {
+    for (IdleMap::iterator it = idle_.begin(); it != idle_.end(); ++it) {
+      for (size_t i = 0; i < it->second.size(); ++i)
+        delete it->second[i];
+    }
+  }
+
+  /**
+   * @brief Creates idle sessions in advance
+   * @param json_session_params - session parameters, see
+   *        OCRStudioSDKInstance::CreateSession()
+   * @param sessions_count - number of idle sessions to have in the pool
+   *        for these parameters after the call, at most max_idle_per_params
+   */
+  void Prewarm(const char* json_session_params, int sessions_count) {
+    const std::string key = detail::CanonicalJSON(json_session_params);
+    if (max_idle_per_params_ > 0 && sessions_count > max_idle_per_params_)
+      sessions_count = max_idle_per_params_;
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (static_cast<int>(idle_[key].size()) >= sessions_count)
+          return;
+      }
+      OCRStudioSDKSession* session = CreateSession(json_session_params);
+      {
+        // Concurrent calls may have filled the pool in the meantime
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<OCRStudioSDKSession*>& idle = idle_[key];
+        if (static_cast<int>(idle.size()) < sessions_count) {
+          idle.push_back(session);
+          ++stats_.idle_sessions;
+          continue;
+        }
+      }
+      delete session;
+      return;
+    }
+  }
+
+  /**
+   * @brief Takes an idle session from the pool, or creates a new one if
+   *        there is no idle session with matching parameters
+   * @param json_session_params - session parameters, see
+   *        OCRStudioSDKInstance::CreateSession()
+   * @return Pointer to a session in its initial state. The session remains
+   *         owned by the pool and must be passed back to Return().
+   */
+  OCRStudioSDKSession* Checkout(const char* json_session_params) {
+    const std::string key = detail::CanonicalJSON(json_session_params);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.checkouts;
+      IdleMap::iterator it = idle_.find(key);
+      if (it != idle_.end() && !it->second.empty()) {
+        OCRStudioSDKSession* session = it->second.back();
+        it->second.pop_back();
+        active_[session] = key;
+        ++stats_.checkout_hits;
+        --stats_.idle_sessions;
+        ++stats_.active_sessions;
+        return session;
+      }
+    }
+    OCRStudioSDKSession* session = CreateSession(json_session_params);
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_[session] = key;
+    ++stats_.active_sessions;
+    return session;
+  }
+
+  /**
+   * @brief Checks out a session like Checkout(), wrapped in a handle which
+   *        returns it to the pool when destroyed, also when processing
+   *        throws
+   * @param json_session_params - session parameters, see
+   *        OCRStudioSDKInstance::CreateSession()
+   * @return Handle of a session in its initial state, must be destroyed
+   *         before the pool
+   */
+  OCRStudioSDKPooledSession CheckoutScoped(const char* json_session_params) {
+    OCRStudioSDKSessionReturner returner;
+    returner.pool = this;
+    return OCRStudioSDKPooledSession(Checkout(json_session_params), returner);
+  }
+
+  /**
+   * @brief Returns a checked out session to the pool, resetting its state
+   * @param session - a session obtained from Checkout()
+   */
+  void Return(OCRStudioSDKSession* session) {
+    std::string key;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ActiveMap::iterator it = active_.find(session);
+      if (it == active_.end()) {
+        throw OCRStudioSDKException(
+            "InvalidArgumentException",
+            "The session was not checked out from this pool");
+      }
+      key.swap(it->second);
+      active_.erase(it);
+      --stats_.active_sessions;
+    }
+
+    try {
+      session->Reset();
+    } catch (...) {
+      // A session which cannot be reset is not reused
+      delete session;
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::vector<OCRStudioSDKSession*>& idle = idle_[key];
+      if (max_idle_per_params_ <= 0 ||
+          static_cast<int>(idle.size()) < max_idle_per_params_) {
+        idle.push_back(session);
+        ++stats_.idle_sessions;
+        return;
+      }
+    }
+    delete session;
+  }
+
+  /// Returns the cumulative counters of the pool
+  OCRStudioSDKSessionPoolStats Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+private:
+  /// Creates a new session, outside of the pool lock
+  OCRStudioSDKSession* CreateSession(const char* json_session_params) {
+    OCRStudioSDKSession* session = instance_.CreateSession(
+        signature_.c_str(), json_session_params);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.sessions_created;
+    return session;
+  }
+
+private:
+  typedef std::map<std::string, std::vector<OCRStudioSDKSession*> > IdleMap;
+  typedef std::map<OCRStudioSDKSession*, std::string> ActiveMap;
+
+  const OCRStudioSDKInstance& instance_;  ///< engine instance
+  std::string signature_;                 ///< authorization signature
+  const int max_idle_per_params_;         ///< idle sessions limit per key
+
+  mutable std::mutex mutex_;              ///< guards the fields below
+  IdleMap idle_;                          ///< idle sessions per canonical params
+  ActiveMap active_;                      ///< checked out sessions and their keys
+  OCRStudioSDKSessionPoolStats stats_;    ///< cumulative counters
+};
+
+
+
+inline void OCRStudioSDKSessionReturner::operator ()(OCRStudioSDKSession* session) const {
+  try {
+    pool->Return(session);
+  } catch (...) {
+    // Destructors must not throw; Return() only throws for foreign sessions
+  }
+}
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_SESSION_POOL_H_INCLUDED
@@ -0,0 +1,367 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_streaming_session.h
+ * @brief Pipelined processing of video frames with a bounded frame queue
+ *        (header-only, built on top of the public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_STREAMING_SESSION_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_STREAMING_SESSION_H_INCLUDED
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <ocrstudiosdk/ocr_studio_session.h>
+#include <ocrstudiosdk/ocr_studio_delegate.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_async_session.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Policy applied to incoming frames when the processing falls behind
+ */
+enum OCRStudioSDKFrameDropPolicy {
+  OCRSTUDIOSDK_FRAME_DROP_OLDEST = 0,  ///< A full queue evicts its oldest frame
+  OCRSTUDIOSDK_FRAME_DROP_NEWEST,      ///< A full queue rejects the incoming frame
+  OCRSTUDIOSDK_FRAME_KEEP_EVERY_NTH    ///< Only every N-th frame is queued, a full
+                                       ///< queue evicts its oldest frame
+};
+
+
+
+/**
+ * @brief Cumulative frame counters of a streaming session
+ */
+struct OCRStudioSDKStreamingStats {
+  long long frames_pushed;     ///< Frames passed to PushFrame()
+  long long frames_processed;  ///< Frames successfully processed
+  long long frames_failed;     ///< Frames for which processing has thrown
+  long long frames_dropped;    ///< Frames dropped without processing
+};
+
+
+
+/**
+ * @brief Session wrapper for video streams. Frames are pushed by the caller
+ *        (e.g. the camera or decoding thread) into a bounded queue and are
+ *        processed in order on a dedicated worker thread, so decoding of the
+ *        next frames overlaps with recognition of the current one. When the
+ *        queue is full, frames are dropped according to the drop policy.
+ *
+ *        If a stats delegate is provided, the following JSON messages are
+ *        passed to its Callback() method:
+ *        {
+ *          "streaming_event": "frame_processed",
+ *          "frame_id": (int),           // 0-based index of the pushed frame
+ *          "queue_ms": (double),        // time spent in the queue
+ *          "processing_ms": (double),   // time spent in ProcessImage()
+ *          "latency_ms": (double),      // total time since PushFrame()
+ *          "frames_dropped": (int)      // cumulative number of dropped frames
+ *        }
+ *        {
+ *          "streaming_event": "frame_dropped",
+ *          "frame_id": (int),
+ *          "reason": "queue_full" | "decimation" | "shutdown",
+ *          "frames_dropped": (int)
+ *        }
+ *        {
+ *          "streaming_event": "frame_failed",
+ *          "frame_id": (int),
+ *          "exception_type": "(type)",
+ *          "exception_message": "(message)"
+ *        }
+ *        The "frame_processed" and "frame_failed" messages are sent from the
+ *        worker thread, "frame_dropped" messages from the thread calling
+ *        PushFrame(), so the delegate must be thread-safe. Frames still
+ *        queued on destruction are dropped with the reason "shutdown",
+ *        reported from the destructor.
+ */
+class OCRStudioSDKStreamingSession {
+public:
+  /**
+   * @brief Main constructor, starts the worker thread
+   * @param session - video session to be fed with frames, the ownership
+   *        is taken by the wrapper
+   * @param queue_capacity - maximum number of frames waiting for processing
+   *        (at least 1)
+   * @param drop_policy - policy for dropping frames
+   * @param keep_every_nth - decimation factor for the
+   *        OCRSTUDIOSDK_FRAME_KEEP_EVERY_NTH policy (at least 1)
+   * @param stats_delegate - optional delegate receiving per-frame latency
+   *        and drop messages, must outlive the wrapper
+   * @param result_delegate - optional delegate receiving the session result
+   *        after every processed frame, must outlive the wrapper
+   */
+  explicit OCRStudioSDKStreamingSession(
+      OCRStudioSDKSession*        session,
+      int                         queue_capacity = 2,
+      OCRStudioSDKFrameDropPolicy drop_policy = OCRSTUDIOSDK_FRAME_DROP_OLDEST,
+      int                         keep_every_nth = 1,
+      OCRStudioSDKDelegate*       stats_delegate = nullptr,
+      OCRStudioSDKResultDelegate* result_delegate = nullptr)
+    : session_(session),
+      queue_capacity_(queue_capacity > 0 ? queue_capacity : 1),
+      drop_policy_(drop_policy),
+      keep_every_nth_(keep_every_nth > 0 ? keep_every_nth : 1),
+      stats_delegate_(stats_delegate),
+      result_delegate_(result_delegate),
+      busy_(false),
+      stopping_(false) {
+    stats_.frames_pushed = 0;
+    stats_.frames_processed = 0;
+    stats_.frames_failed = 0;
+    stats_.frames_dropped = 0;
+    worker_ = std::thread(&OCRStudioSDKStreamingSession::RunWorker, this);
+  }
+
+  /// Destructor, waits for the current frame and drops the queued ones,
+  /// reporting them with the reason "shutdown"
+  ~OCRStudioSDKStreamingSession() {
+    std::deque<QueuedFrame> discarded;
+    long long frames_dropped = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      discarded.swap(queue_);
+      frames_dropped = stats_.frames_dropped;
+      stats_.frames_dropped += static_cast<long long>(discarded.size());
+    }
+    queue_cv_.notify_all();
+    idle_cv_.notify_all();
+    worker_.join();
+
+    if (stats_delegate_) {
+      for (size_t i = 0; i < discarded.size(); ++i) {
+        try {
+          ReportDrop(discarded[i].frame_id, "shutdown", ++frames_dropped);
+        } catch (...) {
+          // Exceptions of the delegate must not escape the destructor
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Pushes a frame to the processing queue
+   * @param frame - the input frame, the ownership is taken by the wrapper,
+   *        must not be null
+   * @return true if the frame was queued, false if it was dropped right away
+   */
+  bool PushFrame(OCRStudioSDKImage* frame) {
+    if (!frame) {
+      throw OCRStudioSDKException(
+          "InvalidArgumentException", "The frame must not be null");
+    }
+    QueuedFrame queued;
+    queued.image.reset(frame);
+    queued.push_time = Clock::now();
+
+    QueuedFrame evicted;
+    bool accepted = true;
+    const char* drop_reason = nullptr;
+    long long frames_dropped = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queued.frame_id = stats_.frames_pushed++;
+      if (drop_policy_ == OCRSTUDIOSDK_FRAME_KEEP_EVERY_NTH &&
+          queued.frame_id % keep_every_nth_ != 0) {
+        accepted = false;
+        drop_reason = "decimation";
+      } else if (static_cast<int>(queue_.size()) >= queue_capacity_) {
+        drop_reason = "queue_full";
+        if (drop_policy_ == OCRSTUDIOSDK_FRAME_DROP_NEWEST) {
+          accepted = false;
+        } else {
+          evicted = std::move(queue_.front());
+          queue_.pop_front();
+        }
+      }
+      if (drop_reason)
+        frames_dropped = ++stats_.frames_dropped;
+      if (accepted)
+        queue_.push_back(std::move(queued));
+    }
+    if (accepted)
+      queue_cv_.notify_one();
+
+    if (drop_reason && stats_delegate_) {
+      ReportDrop(accepted ? evicted.frame_id : queued.frame_id,
+                 drop_reason, frames_dropped);
+    }
+    return accepted;
+  }
+
+  /**
+   * @brief Blocks until all queued frames are processed
+   */
+  void Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+  }
+
+  /// Returns the cumulative frame counters
+  OCRStudioSDKStreamingStats Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  /**
+   * @brief Returns the wrapped session. It may be used directly (e.g. for
+   *        CurrentResult() or Reset()) only while no frames are queued,
+   *        see Flush().
+   */
+  OCRStudioSDKSession& Session() {
+    return *session_;
+  }
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  /// A frame waiting for processing
+  struct QueuedFrame {
+    std::unique_ptr<OCRStudioSDKImage> image;  ///< owned frame
+    long long frame_id;                        ///< 0-based index of the frame
+    Clock::time_point push_time;               ///< time of PushFrame() call
+  };
+
+  /// Milliseconds between two time points
+  static double ElapsedMs(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+  }
+
+  /// Sends the "frame_dropped" message to the stats delegate
+  void ReportDrop(long long frame_id, const char* reason,
+                  long long frames_dropped) {
+    std::string message = "{\"streaming_event\": \"frame_dropped\", \"frame_id\": ";
+    detail::AppendJSONNumber(message, frame_id);
+    message += ", \"reason\": ";
+    detail::AppendJSONString(message, reason);
+    message += ", \"frames_dropped\": ";
+    detail::AppendJSONNumber(message, frames_dropped);
+    message += "}";
+    stats_delegate_->Callback(message.c_str());
+  }
+
+  /// Worker loop: processes queued frames until stopped
+  void RunWorker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      queue_cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+      if (stopping_)
+        break;
+      QueuedFrame frame = std::move(queue_.front());
+      queue_.pop_front();
+      busy_ = true;
+      lock.unlock();
+
+      try {
+        ProcessFrame(frame);
+      } catch (...) {
+        // Exceptions of the delegates must not stop the worker
+      }
+
+      lock.lock();
+      busy_ = false;
+      if (queue_.empty())
+        idle_cv_.notify_all();
+    }
+  }
+
+  /// Processes a single frame and reports the outcome
+  void ProcessFrame(const QueuedFrame& frame) {
+    const Clock::time_point start_time = Clock::now();
+    try {
+      session_->ProcessImage(*frame.image);
+    } catch (const OCRStudioSDKException& e) {
+      ReportFailure(frame, e);
+      return;
+    } catch (const std::exception& e) {
+      ReportFailure(frame, OCRStudioSDKException("InternalException", e.what()));
+      return;
+    } catch (...) {
+      ReportFailure(frame, OCRStudioSDKException(
+          "InternalException", "Unknown exception while processing the frame"));
+      return;
+    }
+    const Clock::time_point end_time = Clock::now();
+
+    long long frames_dropped = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.frames_processed;
+      frames_dropped = stats_.frames_dropped;
+    }
+    if (stats_delegate_) {
+      std::string message = "{\"streaming_event\": \"frame_processed\", \"frame_id\": ";
+      detail::AppendJSONNumber(message, frame.frame_id);
+      message += ", \"queue_ms\": ";
+      detail::AppendJSONNumber(message, ElapsedMs(frame.push_time, start_time));
+      message += ", \"processing_ms\": ";
+      detail::AppendJSONNumber(message, ElapsedMs(start_time, end_time));
+      message += ", \"latency_ms\": ";
+      detail::AppendJSONNumber(message, ElapsedMs(frame.push_time, end_time));
+      message += ", \"frames_dropped\": ";
+      detail::AppendJSONNumber(message, frames_dropped);
+      message += "}";
+      stats_delegate_->Callback(message.c_str());
+    }
+    if (result_delegate_)
+      result_delegate_->ResultCallback(session_->CurrentResult());
+  }
+
+  /// Reports a frame which could not be processed
+  void ReportFailure(const QueuedFrame& frame, const OCRStudioSDKException& e) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.frames_failed;
+    }
+    if (stats_delegate_) {
+      std::string message = "{\"streaming_event\": \"frame_failed\", \"frame_id\": ";
+      detail::AppendJSONNumber(message, frame.frame_id);
+      message += ", \"exception_type\": ";
+      detail::AppendJSONString(message, e.Type());
+      message += ", \"exception_message\": ";
+      detail::AppendJSONString(message, e.Message());
+      message += "}";
+      stats_delegate_->Callback(message.c_str());
+    }
+    if (result_delegate_)
+      result_delegate_->ErrorCallback(e);
+  }
+
+private:
+  std::unique_ptr<OCRStudioSDKSession> session_; ///< wrapped session
+  const int queue_capacity_;                     ///< maximum queue length
+  const OCRStudioSDKFrameDropPolicy drop_policy_;///< frame drop policy
+  const int keep_every_nth_;                     ///< decimation factor
+  OCRStudioSDKDelegate* stats_delegate_;         ///< optional stats delegate
+  OCRStudioSDKResultDelegate* result_delegate_;  ///< optional result delegate
+
+  mutable std::mutex mutex_;                 ///< guards the fields below
+  std::condition_variable queue_cv_;         ///< signals new frames or stop
+  std::condition_variable idle_cv_;          ///< signals an empty queue
+  std::deque<QueuedFrame> queue_;            ///< frames waiting for processing
+  OCRStudioSDKStreamingStats stats_;         ///< cumulative counters
+  bool busy_;                                ///< a frame is being processed
+  bool stopping_;                            ///< destructor was called
+
+  std::thread worker_;                       ///< worker thread
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_STREAMING_SESSION_H_INCLUDED
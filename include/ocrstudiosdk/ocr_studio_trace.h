@@ -0,0 +1,402 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_trace.h
+ * @brief Recording of processing spans into a ring buffer, dumped in the
+ *        Chrome trace-event JSON format (header-only, built on top of the
+ *        public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_TRACE_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_TRACE_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_instance.h>
+#include <ocrstudiosdk/ocr_studio_session.h>
+#include <ocrstudiosdk/ocr_studio_delegate.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Recorded span
+ */
+struct OCRStudioSDKTraceEvent {
+  const char* name;      ///< Span name, a string with static storage duration
+  const char* category;  ///< Span category, a string with static storage duration
+  long long start_us;    ///< Start time in microseconds since recorder creation
+  long long duration_us; ///< Duration in microseconds
+  int thread_id;         ///< Sequential number of the recording thread
+  long long frame_id;    ///< Frame the span belongs to, or -1
+};
+
+namespace detail {
+
+/// Returns a small sequential number of the calling thread
+inline int TraceThreadId() {
+  static std::atomic<int> next_id(1);
+  static thread_local int id = next_id.fetch_add(1);
+  return id;
+}
+
+} // namespace detail
+
+
+
+/**
+ * @brief Ring buffer of spans shared by any number of sessions and threads.
+ *        Once the buffer is full the oldest spans are overwritten, so the
+ *        recorder keeps the most recent activity and can be left running.
+ *        When disabled, spans cost a single atomic load.
+ */
+class OCRStudioSDKTraceRecorder {
+public:
+  /**
+   * @brief Main constructor
+   * @param capacity - maximum number of kept spans
+   * @param enabled - whether recording is initially enabled
+   */
+  explicit OCRStudioSDKTraceRecorder(size_t capacity = 65536, bool enabled = true)
+    : enabled_(enabled),
+      origin_(std::chrono::steady_clock::now()),
+      next_frame_id_(0),
+      capacity_(capacity > 0 ? capacity : 1),
+      next_slot_(0) {}
+
+  /// Non-copyable
+  OCRStudioSDKTraceRecorder(const OCRStudioSDKTraceRecorder&) = delete;
+  OCRStudioSDKTraceRecorder& operator =(const OCRStudioSDKTraceRecorder&) = delete;
+
+  /// Enables or disables recording, may be called from any thread
+  void SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  /// Returns true iff recording is enabled
+  bool Enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the current time in microseconds since recorder creation
+  long long NowMicros() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - origin_).count();
+  }
+
+  /// Returns a new frame identifier, unique within the recorder
+  long long NewFrameId() {
+    return next_frame_id_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Records a span
+   * @param name - span name, must have static storage duration
+   * @param category - span category, must have static storage duration
+   * @param start_us - start time, see NowMicros()
+   * @param duration_us - duration in microseconds
+   * @param frame_id - frame the span belongs to, or -1
+   */
+  void Record(const char* name, const char* category, long long start_us,
+              long long duration_us, long long frame_id = -1) {
+    if (!Enabled())
+      return;
+    OCRStudioSDKTraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.start_us = start_us;
+    event.duration_us = duration_us;
+    event.thread_id = detail::TraceThreadId();
+    event.frame_id = frame_id;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (events_.size() < capacity_)
+      events_.push_back(event);
+    else
+      events_[next_slot_] = event;
+    next_slot_ = (next_slot_ + 1) % capacity_;
+  }
+
+  /// Returns the kept spans, oldest first
+  std::vector<OCRStudioSDKTraceEvent> Events() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (events_.size() < capacity_)
+      return events_;
+    std::vector<OCRStudioSDKTraceEvent> ordered(events_.begin() + next_slot_, events_.end());
+    ordered.insert(ordered.end(), events_.begin(), events_.begin() + next_slot_);
+    return ordered;
+  }
+
+  /// Removes all kept spans
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+    next_slot_ = 0;
+  }
+
+  /**
+   * @brief Returns the kept spans in the Chrome trace-event JSON format, to
+   *        be opened in chrome://tracing or Perfetto. Each span has the
+   *        frame_id argument if it belongs to a frame.
+   * @param min_frame_duration_ms - if positive, only the spans of the frames
+   *        having a span of the "frame" category at least this long are
+   *        included, e.g. the slow ProcessImage() calls
+   * @return JSON document {"traceEvents": [...], "displayTimeUnit": "ms"}
+   */
+  std::string ChromeTraceJSON(double min_frame_duration_ms = 0.0) const {
+    const std::vector<OCRStudioSDKTraceEvent> events = Events();
+    std::set<long long> slow_frames;
+    const bool filter = min_frame_duration_ms > 0.0;
+    if (filter) {
+      for (size_t i = 0; i < events.size(); ++i) {
+        if (events[i].frame_id >= 0 && std::string(events[i].category) == "frame" &&
+            events[i].duration_us >= min_frame_duration_ms * 1000.0)
+          slow_frames.insert(events[i].frame_id);
+      }
+    }
+
+    std::string json = "{\"traceEvents\": [";
+    bool first = true;
+    for (size_t i = 0; i < events.size(); ++i) {
+      const OCRStudioSDKTraceEvent& event = events[i];
+      if (filter && !slow_frames.count(event.frame_id))
+        continue;
+      if (!first)
+        json += ", ";
+      first = false;
+      json += "{\"name\": ";
+      detail::AppendJSONString(json, event.name);
+      json += ", \"cat\": ";
+      detail::AppendJSONString(json, event.category);
+      json += ", \"ph\": \"X\", \"ts\": ";
+      detail::AppendJSONNumber(json, event.start_us);
+      json += ", \"dur\": ";
+      detail::AppendJSONNumber(json, event.duration_us);
+      json += ", \"pid\": 1, \"tid\": ";
+      detail::AppendJSONNumber(json, static_cast<long long>(event.thread_id));
+      if (event.frame_id >= 0) {
+        json += ", \"args\": {\"frame_id\": ";
+        detail::AppendJSONNumber(json, event.frame_id);
+        json += "}";
+      }
+      json += "}";
+    }
+    json += "], \"displayTimeUnit\": \"ms\"}";
+    return json;
+  }
+
+private:
+  std::atomic<bool> enabled_;                   ///< recording enabled
+  const std::chrono::steady_clock::time_point origin_;  ///< time origin
+  std::atomic<long long> next_frame_id_;        ///< next frame identifier
+
+  mutable std::mutex mutex_;                    ///< guards the fields below
+  const size_t capacity_;                       ///< maximum number of spans
+  std::vector<OCRStudioSDKTraceEvent> events_;  ///< ring buffer
+  size_t next_slot_;                            ///< slot of the next span
+};
+
+
+
+/**
+ * @brief Records a span from construction to destruction, e.g. around image
+ *        loading in the caller's code. Does nothing for a null or disabled
+ *        recorder.
+ */
+class OCRStudioSDKTraceSpan {
+public:
+  /**
+   * @brief Main constructor, starts the span
+   * @param recorder - recorder, may be null
+   * @param name - span name, must have static storage duration
+   * @param frame_id - frame the span belongs to, or -1
+   * @param category - span category, must have static storage duration
+   */
+  OCRStudioSDKTraceSpan(OCRStudioSDKTraceRecorder* recorder, const char* name,
+                        long long frame_id = -1, const char* category = "user")
+    : recorder_(recorder && recorder->Enabled() ? recorder : nullptr),
+      name_(name), category_(category), frame_id_(frame_id),
+      start_us_(recorder_ ? recorder_->NowMicros() : 0) {}
+
+  /// Destructor, records the span
+  ~OCRStudioSDKTraceSpan() {
+    if (recorder_)
+      recorder_->Record(name_, category_, start_us_, recorder_->NowMicros() - start_us_, frame_id_);
+  }
+
+  OCRStudioSDKTraceSpan(const OCRStudioSDKTraceSpan&) = delete;
+  OCRStudioSDKTraceSpan& operator =(const OCRStudioSDKTraceSpan&) = delete;
+
+private:
+  OCRStudioSDKTraceRecorder* recorder_;  ///< recorder, null if not recording
+  const char* name_;                     ///< span name
+  const char* category_;                 ///< span category
+  const long long frame_id_;             ///< frame identifier
+  const long long start_us_;             ///< start time
+};
+
+
+
+/**
+ * @brief Session wrapper recording a span of the "frame" category for each
+ *        ProcessImage() and ProcessData() call, each with a new frame
+ *        identifier, and spans of the "session" category for the other calls
+ *        and for the feedback delegate callbacks made during processing.
+ *        Tracing is enabled per session; a disabled session costs one
+ *        atomic load per call.
+ */
+class OCRStudioSDKTracedSession : public OCRStudioSDKSession {
+public:
+  /**
+   * @brief Creates a session wrapped for tracing, with the feedback
+   *        delegate callbacks traced as well
+   * @param instance - the configured engine instance
+   * @param authorization_signature - personalized signature
+   * @param json_session_params - session parameters in JSON format
+   * @param recorder - span recorder, must outlive the session
+   * @param callback_delegate - optional feedback delegate, must outlive the
+   *        session
+   * @param enabled - whether tracing of the session is initially enabled
+   * @return Pointer to a new session, the ownership is relinquished.
+   */
+  static OCRStudioSDKTracedSession* Create(
+      const OCRStudioSDKInstance& instance,
+      const char*                 authorization_signature,
+      const char*                 json_session_params,
+      OCRStudioSDKTraceRecorder&  recorder,
+      OCRStudioSDKDelegate*       callback_delegate = nullptr,
+      bool                        enabled = true) {
+    std::unique_ptr<OCRStudioSDKTracedSession> traced(
+        new OCRStudioSDKTracedSession(recorder, enabled));
+    traced->feedback_.reset(new FeedbackDelegate(*traced, callback_delegate));
+    traced->session_.reset(instance.CreateSession(
+        authorization_signature, json_session_params, traced->feedback_.get()));
+    return traced.release();
+  }
+
+  /**
+   * @brief Wraps an existing session; its feedback delegate is not traced
+   * @param session - session to be wrapped, the ownership is taken
+   * @param recorder - span recorder, must outlive the session
+   * @param enabled - whether tracing of the session is initially enabled
+   */
+  OCRStudioSDKTracedSession(OCRStudioSDKSession*       session,
+                            OCRStudioSDKTraceRecorder& recorder,
+                            bool                       enabled = true)
+    : OCRStudioSDKTracedSession(recorder, enabled) {
+    session_.reset(session);
+  }
+
+  /// Enables or disables tracing of the session
+  void SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  /// Returns true iff tracing of the session is enabled
+  bool Enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the identifier of the frame being or last processed, or -1
+  long long CurrentFrameId() const {
+    return frame_id_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the wrapped session
+  OCRStudioSDKSession& Session() {
+    return *session_;
+  }
+
+  virtual const char* Description() const override {
+    return session_->Description();
+  }
+
+  virtual void ProcessImage(const OCRStudioSDKImage& image) override {
+    if (!Enabled()) {
+      session_->ProcessImage(image);
+      return;
+    }
+    frame_id_.store(recorder_.NewFrameId(), std::memory_order_relaxed);
+    OCRStudioSDKTraceSpan span(&recorder_, "ProcessImage", CurrentFrameId(), "frame");
+    session_->ProcessImage(image);
+  }
+
+  virtual void ProcessData(const char* data_str) override {
+    if (!Enabled()) {
+      session_->ProcessData(data_str);
+      return;
+    }
+    frame_id_.store(recorder_.NewFrameId(), std::memory_order_relaxed);
+    OCRStudioSDKTraceSpan span(&recorder_, "ProcessData", CurrentFrameId(), "frame");
+    session_->ProcessData(data_str);
+  }
+
+  virtual const OCRStudioSDKResult& CurrentResult() const override {
+    if (!Enabled())
+      return session_->CurrentResult();
+    OCRStudioSDKTraceSpan span(&recorder_, "CurrentResult", CurrentFrameId(), "session");
+    return session_->CurrentResult();
+  }
+
+  virtual void Reset() override {
+    if (!Enabled()) {
+      session_->Reset();
+      return;
+    }
+    OCRStudioSDKTraceSpan span(&recorder_, "Reset", -1, "session");
+    session_->Reset();
+  }
+
+  virtual void Suspend() override {
+    session_->Suspend();
+  }
+
+  virtual void Resume() override {
+    session_->Resume();
+  }
+
+private:
+  /// Forwards feedback messages, tracing the time spent in the delegate
+  class FeedbackDelegate : public OCRStudioSDKDelegate {
+  public:
+    FeedbackDelegate(OCRStudioSDKTracedSession& owner, OCRStudioSDKDelegate* delegate)
+      : owner_(owner), delegate_(delegate) {}
+
+    virtual void Callback(const char* json_message) override {
+      OCRStudioSDKTraceSpan span(owner_.Enabled() ? &owner_.recorder_ : nullptr,
+                                 "Feedback", owner_.CurrentFrameId(), "session");
+      if (delegate_)
+        delegate_->Callback(json_message);
+    }
+
+  private:
+    OCRStudioSDKTracedSession& owner_;  ///< traced session
+    OCRStudioSDKDelegate* delegate_;    ///< user delegate, may be null
+  };
+
+  OCRStudioSDKTracedSession(OCRStudioSDKTraceRecorder& recorder, bool enabled)
+    : recorder_(recorder), enabled_(enabled), frame_id_(-1) {}
+
+private:
+  OCRStudioSDKTraceRecorder& recorder_;           ///< span recorder
+  std::atomic<bool> enabled_;                     ///< tracing enabled
+  std::atomic<long long> frame_id_;               ///< current frame
+
+  // The delegate is declared before the session so that it outlives it
+  std::unique_ptr<FeedbackDelegate> feedback_;    ///< tracing delegate
+  std::unique_ptr<OCRStudioSDKSession> session_;  ///< wrapped session
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_TRACE_H_INCLUDED
@@ -0,0 +1,153 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_warmup.h
+ * @brief Explicit warmup of lazily initialized engine components
+ *        (header-only, built on top of the public session interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_WARMUP_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_WARMUP_H_INCLUDED
+
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ocrstudiosdk/ocr_studio_instance.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief Warms up an engine instance created with lazy or delayed
+ *        initialization. With "enable_lazy_initialization" or
+ *        "enable_delayed_initialization" the engine initializes the
+ *        components of a target group when a session requiring them is
+ *        created, so creating a session for the targets actually in use
+ *        moves that cost from the first request to startup, without
+ *        initializing the rest of the configuration bundle.
+ *
+ *        The helper keeps track of the session parameters it has warmed up;
+ *        the components actually resident in the engine are not observable
+ *        through the public interface.
+ */
+class OCRStudioSDKInstanceWarmup {
+public:
+  /**
+   * @brief Main constructor
+   * @param instance - engine instance, must outlive the helper
+   * @param authorization_signature - signature of an authorized SDK user
+   */
+  OCRStudioSDKInstanceWarmup(
+      const OCRStudioSDKInstance& instance,
+      const char*                 authorization_signature)
+    : instance_(instance),
+      signature_(authorization_signature) {}
+
+  /**
+   * @brief Synchronously initializes the components needed for a session
+   * @param json_session_params - parameters of the sessions to be served,
+   *        see OCRStudioSDKInstance::CreateSession(). Only the targets
+   *        selected by "target_masks" are initialized.
+   * @param process_blank_frame - additionally process a small blank image,
+   *        to initialize components which are only set up on the first
+   *        processing call
+   */
+  void Warmup(const char* json_session_params, bool process_blank_frame = false) {
+    const std::chrono::steady_clock::time_point start_time =
+        std::chrono::steady_clock::now();
+    {
+      std::unique_ptr<OCRStudioSDKSession> session(
+          instance_.CreateSession(signature_.c_str(), json_session_params));
+      if (process_blank_frame) {
+        const int kBlankSize = 64;
+        std::vector<unsigned char> pixels(kBlankSize * kBlankSize, 0);
+        std::unique_ptr<OCRStudioSDKImage> blank(OCRStudioSDKImage::CreateFromBuffer(
+            pixels.data(), static_cast<int>(pixels.size()),
+            kBlankSize, kBlankSize, kBlankSize, 1));
+        session->ProcessImage(*blank);
+      }
+    }
+    const double duration_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start_time).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    warmed_up_[detail::CanonicalJSON(json_session_params)] = duration_ms;
+  }
+
+  /**
+   * @brief Asynchronously initializes the components needed for a session,
+   *        see Warmup()
+   * @return Future which becomes ready when the warmup is complete, holding
+   *         the OCRStudioSDKException thrown by the warmup if any. The
+   *         helper must outlive the future.
+   */
+  std::future<void> WarmupAsync(
+      const char* json_session_params, bool process_blank_frame = false) {
+    const std::string params(json_session_params);
+    return std::async(std::launch::async, [this, params, process_blank_frame]() {
+      Warmup(params.c_str(), process_blank_frame);
+    });
+  }
+
+  /**
+   * @brief Checks whether a session with the given parameters was warmed up
+   * @param json_session_params - session parameters, compared in their
+   *        canonical JSON form
+   */
+  bool IsWarm(const char* json_session_params) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return warmed_up_.count(detail::CanonicalJSON(json_session_params)) > 0;
+  }
+
+  /**
+   * @brief Returns the warmed up session parameters in JSON format
+   * @return a JSON description in the following format:
+   *         {
+   *           "warmed_up": [
+   *             {
+   *               "session_params": { (canonical session parameters) },
+   *               "duration_ms": (double)
+   *             },
+   *             ...
+   *           ]
+   *         }
+   */
+  std::string Description() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string description = "{\"warmed_up\": [";
+    for (std::map<std::string, double>::const_iterator it = warmed_up_.begin();
+         it != warmed_up_.end(); ++it) {
+      if (it != warmed_up_.begin())
+        description += ", ";
+      description += "{\"session_params\": ";
+      description += it->first;
+      description += ", \"duration_ms\": ";
+      detail::AppendJSONNumber(description, it->second);
+      description += "}";
+    }
+    description += "]}";
+    return description;
+  }
+
+private:
+  const OCRStudioSDKInstance& instance_;  ///< engine instance
+  std::string signature_;                 ///< authorization signature
+
+  mutable std::mutex mutex_;              ///< guards warmed_up_
+  /// Warmup durations by canonical session parameters
+  std::map<std::string, double> warmed_up_;
+};
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_WARMUP_H_INCLUDED
@@ -0,0 +1,441 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+/**
+ * @file ocr_studio_yuv.h
+ * @brief Vectorized YUV 4:2:0 to RGB and grayscale conversion
+ *        (header-only, built on top of the public image interface)
+ */
+
+#pragma once
+#ifndef OCRSTUDIOSDK_OCR_STUDIO_YUV_H_INCLUDED
+#define OCRSTUDIOSDK_OCR_STUDIO_YUV_H_INCLUDED
+
+#include <cstring>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+# define OCRSTUDIOSDK_YUV_HAVE_SSSE3 1
+# include <tmmintrin.h>
+#endif // x86 and gcc or clang
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define OCRSTUDIOSDK_YUV_HAVE_NEON 1
+# include <arm_neon.h>
+#endif // __ARM_NEON
+
+#include <ocrstudiosdk/ocr_studio_image.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+
+namespace ocrstudio {
+
+/**
+ * @brief YUV conversion kernel
+ */
+enum OCRStudioSDKYUVKernel {
+  OCRSTUDIOSDK_YUV_KERNEL_AUTO = 0,  ///< Best kernel supported by the CPU
+  OCRSTUDIOSDK_YUV_KERNEL_SCALAR,    ///< Portable scalar kernel
+  OCRSTUDIOSDK_YUV_KERNEL_SSSE3,     ///< x86 SSSE3 kernel
+  OCRSTUDIOSDK_YUV_KERNEL_NEON       ///< ARM NEON kernel
+};
+
+namespace detail {
+
+// BT.601 limited range conversion in 6-bit fixed point. The products fit
+// into 16 bits, so the vector kernels compute in 16-bit lanes; intermediate
+// saturation only affects values which are clipped anyway, so all kernels
+// produce identical output:
+//   R = (74 * (Y - 16) + 102 * (V - 128) + 32) >> 6
+//   G = (74 * (Y - 16) - 25 * (U - 128) - 52 * (V - 128) + 32) >> 6
+//   B = (74 * (Y - 16) + 129 * (U - 128) + 32) >> 6
+
+inline unsigned char ClipYUVComponent(int value) {
+  return static_cast<unsigned char>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+/// Converts pixels [x_begin, x_end) of a row, any pixel strides
+inline void ConvertYUVRowScalar(
+    const unsigned char* y, int y_pixel_stride,
+    const unsigned char* u, const unsigned char* v, int u_pixel_stride,
+    int v_pixel_stride, int x_begin, int x_end, unsigned char* rgb) {
+  for (int x = x_begin; x < x_end; ++x) {
+    const int c = 74 * (y[x * y_pixel_stride] - 16) + 32;
+    const int d = u[(x >> 1) * u_pixel_stride] - 128;
+    const int e = v[(x >> 1) * v_pixel_stride] - 128;
+    rgb[3 * x + 0] = ClipYUVComponent((c + 102 * e) >> 6);
+    rgb[3 * x + 1] = ClipYUVComponent((c - 25 * d - 52 * e) >> 6);
+    rgb[3 * x + 2] = ClipYUVComponent((c + 129 * d) >> 6);
+  }
+}
+
+#if defined(OCRSTUDIOSDK_YUV_HAVE_SSSE3)
+
+/// Returns true iff the CPU supports SSSE3
+inline bool CPUSupportsSSSE3() {
+  static const bool supported = __builtin_cpu_supports("ssse3") != 0;
+  return supported;
+}
+
+/// Computes 8 output components from 16-bit Y and chroma terms
+__attribute__((target("ssse3")))
+inline void ComputeRGB16SSSE3(
+    __m128i y16, __m128i d16, __m128i e16,
+    __m128i& r, __m128i& g, __m128i& b) {
+  const __m128i c = _mm_add_epi16(
+      _mm_mullo_epi16(_mm_sub_epi16(y16, _mm_set1_epi16(16)), _mm_set1_epi16(74)),
+      _mm_set1_epi16(32));
+  r = _mm_srai_epi16(_mm_adds_epi16(c, _mm_mullo_epi16(e16, _mm_set1_epi16(102))), 6);
+  g = _mm_srai_epi16(_mm_subs_epi16(
+      _mm_subs_epi16(c, _mm_mullo_epi16(d16, _mm_set1_epi16(25))),
+      _mm_mullo_epi16(e16, _mm_set1_epi16(52))), 6);
+  b = _mm_srai_epi16(_mm_adds_epi16(c, _mm_mullo_epi16(d16, _mm_set1_epi16(129))), 6);
+}
+
+/// Shuffle masks interleaving 16 R, G and B bytes into 48 RGB bytes
+struct RGBInterleaveMasks {
+  unsigned char m[3][3][16];  ///< [output block][source channel][byte]
+  RGBInterleaveMasks() {
+    for (int block = 0; block < 3; ++block) {
+      for (int channel = 0; channel < 3; ++channel) {
+        for (int i = 0; i < 16; ++i) {
+          const int out = block * 16 + i;
+          m[block][channel][i] = static_cast<unsigned char>(
+              out % 3 == channel ? out / 3 : 0x80);
+        }
+      }
+    }
+  }
+};
+
+/**
+ * @brief Converts the pixels of a row in blocks of 16, Y pixel stride 1,
+ *        chroma pixel stride 1 (planar) or 2 (semi-planar)
+ * @return the number of converted pixels
+ */
+__attribute__((target("ssse3")))
+inline int ConvertYUVRowSSSE3(
+    const unsigned char* y, const unsigned char* u, const unsigned char* v,
+    int uv_pixel_stride, int width, unsigned char* rgb) {
+  static const RGBInterleaveMasks masks;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i chroma_bias = _mm_set1_epi16(128);
+  const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+
+  // Semi-planar chroma loads read 16 bytes, one past the last needed byte
+  const int x_end = (uv_pixel_stride == 2) ? width - 1 : width;
+  int x = 0;
+  for (; x + 16 <= x_end; x += 16) {
+    const __m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+    __m128i u16, v16;
+    if (uv_pixel_stride == 1) {
+      u16 = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x / 2)), zero);
+      v16 = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x / 2)), zero);
+    } else {
+      u16 = _mm_and_si128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x)), low_bytes);
+      v16 = _mm_and_si128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + x)), low_bytes);
+    }
+    const __m128i d16 = _mm_sub_epi16(u16, chroma_bias);
+    const __m128i e16 = _mm_sub_epi16(v16, chroma_bias);
+
+    __m128i r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+    ComputeRGB16SSSE3(_mm_unpacklo_epi8(y8, zero), _mm_unpacklo_epi16(d16, d16),
+                      _mm_unpacklo_epi16(e16, e16), r_lo, g_lo, b_lo);
+    ComputeRGB16SSSE3(_mm_unpackhi_epi8(y8, zero), _mm_unpackhi_epi16(d16, d16),
+                      _mm_unpackhi_epi16(e16, e16), r_hi, g_hi, b_hi);
+    const __m128i r8 = _mm_packus_epi16(r_lo, r_hi);
+    const __m128i g8 = _mm_packus_epi16(g_lo, g_hi);
+    const __m128i b8 = _mm_packus_epi16(b_lo, b_hi);
+
+    for (int block = 0; block < 3; ++block) {
+      const __m128i out = _mm_or_si128(
+          _mm_or_si128(
+              _mm_shuffle_epi8(r8, _mm_loadu_si128(
+                  reinterpret_cast<const __m128i*>(masks.m[block][0]))),
+              _mm_shuffle_epi8(g8, _mm_loadu_si128(
+                  reinterpret_cast<const __m128i*>(masks.m[block][1])))),
+          _mm_shuffle_epi8(b8, _mm_loadu_si128(
+              reinterpret_cast<const __m128i*>(masks.m[block][2]))));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + 3 * x + 16 * block), out);
+    }
+  }
+  return x;
+}
+
+#endif // OCRSTUDIOSDK_YUV_HAVE_SSSE3
+
+#if defined(OCRSTUDIOSDK_YUV_HAVE_NEON)
+
+/// Computes 8 output components from 16-bit Y and chroma terms
+inline void ComputeRGB16NEON(
+    int16x8_t y16, int16x8_t d16, int16x8_t e16,
+    int16x8_t& r, int16x8_t& g, int16x8_t& b) {
+  const int16x8_t c = vaddq_s16(
+      vmulq_n_s16(vsubq_s16(y16, vdupq_n_s16(16)), 74), vdupq_n_s16(32));
+  r = vshrq_n_s16(vqaddq_s16(c, vmulq_n_s16(e16, 102)), 6);
+  g = vshrq_n_s16(vqsubq_s16(vqsubq_s16(c, vmulq_n_s16(d16, 25)),
+                             vmulq_n_s16(e16, 52)), 6);
+  b = vshrq_n_s16(vqaddq_s16(c, vmulq_n_s16(d16, 129)), 6);
+}
+
+/**
+ * @brief Converts the pixels of a row in blocks of 16, Y pixel stride 1,
+ *        chroma pixel stride 1 (planar) or 2 (semi-planar)
+ * @return the number of converted pixels
+ */
+inline int ConvertYUVRowNEON(
+    const unsigned char* y, const unsigned char* u, const unsigned char* v,
+    int uv_pixel_stride, int width, unsigned char* rgb) {
+  const int x_end = (uv_pixel_stride == 2) ? width - 1 : width;
+  int x = 0;
+  for (; x + 16 <= x_end; x += 16) {
+    const uint8x16_t y8 = vld1q_u8(y + x);
+    uint8x8_t u8, v8;
+    if (uv_pixel_stride == 1) {
+      u8 = vld1_u8(u + x / 2);
+      v8 = vld1_u8(v + x / 2);
+    } else {
+      u8 = vmovn_u16(vreinterpretq_u16_u8(vld1q_u8(u + x)));
+      v8 = vmovn_u16(vreinterpretq_u16_u8(vld1q_u8(v + x)));
+    }
+    const int16x8_t d16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8)), vdupq_n_s16(128));
+    const int16x8_t e16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8)), vdupq_n_s16(128));
+    const int16x8x2_t d_dup = vzipq_s16(d16, d16);
+    const int16x8x2_t e_dup = vzipq_s16(e16, e16);
+
+    int16x8_t r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+    ComputeRGB16NEON(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y8))),
+                     d_dup.val[0], e_dup.val[0], r_lo, g_lo, b_lo);
+    ComputeRGB16NEON(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y8))),
+                     d_dup.val[1], e_dup.val[1], r_hi, g_hi, b_hi);
+    uint8x16x3_t out;
+    out.val[0] = vcombine_u8(vqmovun_s16(r_lo), vqmovun_s16(r_hi));
+    out.val[1] = vcombine_u8(vqmovun_s16(g_lo), vqmovun_s16(g_hi));
+    out.val[2] = vcombine_u8(vqmovun_s16(b_lo), vqmovun_s16(b_hi));
+    vst3q_u8(rgb + 3 * x, out);
+  }
+  return x;
+}
+
+#endif // OCRSTUDIOSDK_YUV_HAVE_NEON
+
+/// Per-thread scratch buffer for converted pixels
+inline std::vector<unsigned char>& YUVScratchBuffer() {
+  static thread_local std::vector<unsigned char> buffer;
+  return buffer;
+}
+
+} // namespace detail
+
+
+
+/**
+ * @brief Resolves the conversion kernel to be used
+ * @param requested - requested kernel; OCRSTUDIOSDK_YUV_KERNEL_AUTO or a
+ *        kernel not supported by the CPU or the build resolve to the best
+ *        supported kernel
+ * @return The kernel which will be used
+ */
+inline OCRStudioSDKYUVKernel SelectYUVKernel(
+    OCRStudioSDKYUVKernel requested = OCRSTUDIOSDK_YUV_KERNEL_AUTO) {
+  if (requested == OCRSTUDIOSDK_YUV_KERNEL_SCALAR)
+    return OCRSTUDIOSDK_YUV_KERNEL_SCALAR;
+#if defined(OCRSTUDIOSDK_YUV_HAVE_NEON)
+  return OCRSTUDIOSDK_YUV_KERNEL_NEON;
+#elif defined(OCRSTUDIOSDK_YUV_HAVE_SSSE3)
+  return detail::CPUSupportsSSSE3() ? OCRSTUDIOSDK_YUV_KERNEL_SSSE3
+                                    : OCRSTUDIOSDK_YUV_KERNEL_SCALAR;
+#else
+  return OCRSTUDIOSDK_YUV_KERNEL_SCALAR;
+#endif
+}
+
+/**
+ * @brief Converts a YUV 4:2:0 image (NV21, NV12, I420 or generic 420_888
+ *        with arbitrary strides) to 8-bit RGB. The vector kernels handle
+ *        Y pixel stride 1 with chroma pixel stride 1 or 2 (equal for U and V),
+ *        other layouts are converted by the scalar kernel.
+ * @param y_plane - pointer to Y plane buffer
+ * @param y_plane_row_stride - Y plane row stride
+ * @param y_plane_pixel_stride - Y plane pixel stride
+ * @param u_plane - pointer to U plane buffer
+ * @param u_plane_row_stride - U plane row stride
+ * @param u_plane_pixel_stride - U plane pixel stride
+ * @param v_plane - pointer to V plane buffer
+ * @param v_plane_row_stride - V plane row stride
+ * @param v_plane_pixel_stride - V plane pixel stride
+ * @param width - image width in pixels
+ * @param height - image height in pixels
+ * @param rgb - output RGB buffer
+ * @param rgb_bytes_per_line - output row size in bytes, at least 3 * width
+ * @param kernel - conversion kernel, see SelectYUVKernel()
+ */
+inline void ConvertYUV420ToRGB(
+    const unsigned char* y_plane,
+    int                  y_plane_row_stride,
+    int                  y_plane_pixel_stride,
+    const unsigned char* u_plane,
+    int                  u_plane_row_stride,
+    int                  u_plane_pixel_stride,
+    const unsigned char* v_plane,
+    int                  v_plane_row_stride,
+    int                  v_plane_pixel_stride,
+    int                  width,
+    int                  height,
+    unsigned char*       rgb,
+    int                  rgb_bytes_per_line,
+    OCRStudioSDKYUVKernel kernel = OCRSTUDIOSDK_YUV_KERNEL_AUTO) {
+  kernel = SelectYUVKernel(kernel);
+  const bool vector_layout =
+      y_plane_pixel_stride == 1 && u_plane_pixel_stride == v_plane_pixel_stride &&
+      (u_plane_pixel_stride == 1 || u_plane_pixel_stride == 2);
+
+  for (int row = 0; row < height; ++row) {
+    const unsigned char* y = y_plane + row * y_plane_row_stride;
+    const unsigned char* u = u_plane + (row >> 1) * u_plane_row_stride;
+    const unsigned char* v = v_plane + (row >> 1) * v_plane_row_stride;
+    unsigned char* out = rgb + row * rgb_bytes_per_line;
+    int converted = 0;
+    if (vector_layout) {
+#if defined(OCRSTUDIOSDK_YUV_HAVE_NEON)
+      if (kernel == OCRSTUDIOSDK_YUV_KERNEL_NEON)
+        converted = detail::ConvertYUVRowNEON(y, u, v, u_plane_pixel_stride, width, out);
+#endif // OCRSTUDIOSDK_YUV_HAVE_NEON
+#if defined(OCRSTUDIOSDK_YUV_HAVE_SSSE3)
+      if (kernel == OCRSTUDIOSDK_YUV_KERNEL_SSSE3)
+        converted = detail::ConvertYUVRowSSSE3(y, u, v, u_plane_pixel_stride, width, out);
+#endif // OCRSTUDIOSDK_YUV_HAVE_SSSE3
+    }
+    detail::ConvertYUVRowScalar(y, y_plane_pixel_stride, u, v,
+                                u_plane_pixel_stride, v_plane_pixel_stride,
+                                converted, width, out);
+  }
+}
+
+/**
+ * @brief Creates an RGB image from a universal YUV 4:2:0 buffer using the
+ *        vectorized conversion, see ConvertYUV420ToRGB(). The parameters
+ *        follow OCRStudioSDKImage::CreateFromYUV(); the conversion goes
+ *        through a per-thread scratch buffer, so no per-frame allocation
+ *        is made for the intermediate RGB data.
+ * @return Pointer to a new image, the ownership is relinquished.
+ */
+inline OCRStudioSDKImage* CreateRGBImageFromYUV(
+    const unsigned char* y_plane,
+    int                  y_plane_row_stride,
+    int                  y_plane_pixel_stride,
+    const unsigned char* u_plane,
+    int                  u_plane_row_stride,
+    int                  u_plane_pixel_stride,
+    const unsigned char* v_plane,
+    int                  v_plane_row_stride,
+    int                  v_plane_pixel_stride,
+    int                  width,
+    int                  height,
+    OCRStudioSDKYUVKernel kernel = OCRSTUDIOSDK_YUV_KERNEL_AUTO) {
+  if (width <= 0 || height <= 0)
+    throw OCRStudioSDKException("InvalidArgumentException", "Invalid YUV image size");
+  std::vector<unsigned char>& rgb = detail::YUVScratchBuffer();
+  rgb.resize(static_cast<size_t>(width) * height * 3);
+  ConvertYUV420ToRGB(y_plane, y_plane_row_stride, y_plane_pixel_stride,
+                     u_plane, u_plane_row_stride, u_plane_pixel_stride,
+                     v_plane, v_plane_row_stride, v_plane_pixel_stride,
+                     width, height, rgb.data(), width * 3, kernel);
+  return OCRStudioSDKImage::CreateFromBuffer(
+      rgb.data(), static_cast<int>(rgb.size()), width, height, width * 3, 3);
+}
+
+/**
+ * @brief Creates a grayscale image from the Y plane of a YUV buffer, for
+ *        sessions which only need luminance. With Y pixel stride 1 the plane
+ *        is passed to the image as-is, without any conversion.
+ * @param y_plane - pointer to Y plane buffer
+ * @param y_plane_size - Y plane buffer size
+ * @param y_plane_row_stride - Y plane row stride
+ * @param y_plane_pixel_stride - Y plane pixel stride
+ * @param width - image width in pixels
+ * @param height - image height in pixels
+ * @return Pointer to a new image, the ownership is relinquished.
+ */
+inline OCRStudioSDKImage* CreateGrayImageFromYUV(
+    const unsigned char* y_plane,
+    int                  y_plane_size,
+    int                  y_plane_row_stride,
+    int                  y_plane_pixel_stride,
+    int                  width,
+    int                  height) {
+  if (width <= 0 || height <= 0)
+    throw OCRStudioSDKException("InvalidArgumentException", "Invalid YUV image size");
+  if (y_plane_pixel_stride == 1) {
+    // CreateFromBuffer() takes a mutable pointer but only copies the pixels
+    return OCRStudioSDKImage::CreateFromBuffer(
+        const_cast<unsigned char*>(y_plane), y_plane_size,
+        width, height, y_plane_row_stride, 1);
+  }
+  std::vector<unsigned char>& gray = detail::YUVScratchBuffer();
+  gray.resize(static_cast<size_t>(width) * height);
+  for (int row = 0; row < height; ++row) {
+    const unsigned char* y = y_plane + row * y_plane_row_stride;
+    unsigned char* out = gray.data() + row * width;
+    for (int x = 0; x < width; ++x)
+      out[x] = y[x * y_plane_pixel_stride];
+  }
+  return OCRStudioSDKImage::CreateFromBuffer(
+      gray.data(), static_cast<int>(gray.size()), width, height, width, 1);
+}
+
+/**
+ * @brief Creates an RGB image from a simple YUV NV21 buffer (Y plane
+ *        followed by interleaved V/U samples), see CreateRGBImageFromYUV()
+ * @param yuv_data - pointer to YUV NV21 buffer
+ * @param yuv_data_size - size of the YUV NV21 buffer
+ * @param width - width of the image in pixels
+ * @param height - height of the image in pixels
+ * @param kernel - conversion kernel, see SelectYUVKernel()
+ * @return Pointer to a new image, the ownership is relinquished.
+ */
+inline OCRStudioSDKImage* CreateRGBImageFromNV21(
+    const unsigned char* yuv_data,
+    int                  yuv_data_size,
+    int                  width,
+    int                  height,
+    OCRStudioSDKYUVKernel kernel = OCRSTUDIOSDK_YUV_KERNEL_AUTO) {
+  const int chroma_row_stride = (width + 1) / 2 * 2;
+  if (width <= 0 || height <= 0 ||
+      yuv_data_size < width * height + chroma_row_stride * ((height + 1) / 2))
+    throw OCRStudioSDKException("InvalidArgumentException", "Invalid NV21 buffer size");
+  const unsigned char* vu = yuv_data + width * height;
+  return CreateRGBImageFromYUV(yuv_data, width, 1,
+                               vu + 1, chroma_row_stride, 2,
+                               vu, chroma_row_stride, 2,
+                               width, height, kernel);
+}
+
+/**
+ * @brief Creates a grayscale image from a simple YUV NV21 buffer, without
+ *        any color conversion, see CreateGrayImageFromYUV()
+ * @param yuv_data - pointer to YUV NV21 buffer
+ * @param yuv_data_size - size of the YUV NV21 buffer
+ * @param width - width of the image in pixels
+ * @param height - height of the image in pixels
+ * @return Pointer to a new image, the ownership is relinquished.
+ */
+inline OCRStudioSDKImage* CreateGrayImageFromNV21(
+    const unsigned char* yuv_data,
+    int                  yuv_data_size,
+    int                  width,
+    int                  height) {
+  if (width <= 0 || height <= 0 || yuv_data_size < width * height)
+    throw OCRStudioSDKException("InvalidArgumentException", "Invalid NV21 buffer size");
+  return CreateGrayImageFromYUV(yuv_data, width * height, width, 1, width, height);
+}
+
+} // namespace ocrstudio
+
+#endif // OCRSTUDIOSDK_OCR_STUDIO_YUV_H_INCLUDED
@@ -0,0 +1 @@
+g++ ocrstudiosdk_bench.cpp -O2 -std=c++11 -pthread -I ../../include -L ../../bin -l ocrstudiosdk -o ocrstudiosdk_bench
@@ -0,0 +1,401 @@
+/**
+  Copyright (c) 2024-2025, OCR Studio
+  All rights reserved.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/resource.h>
+
+#include <ocrstudiosdk/ocr_studio_instance.h>
+#include <ocrstudiosdk/ocr_studio_exception.h>
+#include <ocrstudiosdk/ocr_studio_result.h>
+#include <ocrstudiosdk/ocr_studio_json_utils.h>
+
+// Benchmark of the recognition pipeline: loads every image of a directory,
+//     runs warmup passes and then the measured iterations over all images
+//     on several threads (one session per thread), and prints a JSON report
+//     with the throughput, latency percentiles, per-stage timings and the
+//     peak resident memory.
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Timings of a pipeline stage, in milliseconds
+struct StageTimings {
+  std::vector<double> samples;
+  long long errors = 0;
+
+  void Merge(const StageTimings& other) {
+    samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+    errors += other.errors;
+  }
+};
+
+// Nearest-rank percentile of sorted samples
+double Percentile(const std::vector<double>& sorted, double percent) {
+  if (sorted.empty())
+    return 0.0;
+  size_t rank = static_cast<size_t>(percent / 100.0 * sorted.size() + 0.999999);
+  if (rank < 1)
+    rank = 1;
+  if (rank > sorted.size())
+    rank = sorted.size();
+  return sorted[rank - 1];
+}
+
+void AppendStage(std::string& json, const char* name, StageTimings& stage) {
+  std::sort(stage.samples.begin(), stage.samples.end());
+  double total = 0.0;
+  for (size_t i = 0; i < stage.samples.size(); ++i)
+    total += stage.samples[i];
+  ocrstudio::detail::AppendJSONString(json, name);
+  json += ": {\"count\": ";
+  ocrstudio::detail::AppendJSONNumber(json, static_cast<long long>(stage.samples.size()));
+  json += ", \"errors\": ";
+  ocrstudio::detail::AppendJSONNumber(json, stage.errors);
+  json += ", \"mean_ms\": ";
+  ocrstudio::detail::AppendJSONNumber(
+      json, stage.samples.empty() ? 0.0 : total / stage.samples.size());
+  json += ", \"p50_ms\": ";
+  ocrstudio::detail::AppendJSONNumber(json, Percentile(stage.samples, 50.0));
+  json += ", \"p95_ms\": ";
+  ocrstudio::detail::AppendJSONNumber(json, Percentile(stage.samples, 95.0));
+  json += ", \"p99_ms\": ";
+  ocrstudio::detail::AppendJSONNumber(json, Percentile(stage.samples, 99.0));
+  json += ", \"max_ms\": ";
+  ocrstudio::detail::AppendJSONNumber(
+      json, stage.samples.empty() ? 0.0 : stage.samples.back());
+  json += "}";
+}
+
+// Peak resident set size of the process in bytes
+long long PeakRSSBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(__APPLE__)
+  return static_cast<long long>(usage.ru_maxrss);         // bytes
+#else
+  return static_cast<long long>(usage.ru_maxrss) * 1024;  // kilobytes
+#endif
+}
+
+bool HasImageExtension(const std::string& filename) {
+  static const char* const extensions[] = {
+      ".jpg", ".jpeg", ".png", ".tif", ".tiff", ".bmp", ".webp"};
+  const size_t dot = filename.rfind('.');
+  if (dot == std::string::npos)
+    return false;
+  std::string extension = filename.substr(dot);
+  for (size_t i = 0; i < extension.size(); ++i)
+    extension[i] = static_cast<char>(tolower(extension[i]));
+  for (size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]); ++i) {
+    if (extension == extensions[i])
+      return true;
+  }
+  return false;
+}
+
+std::vector<std::string> ListImages(const std::string& directory) {
+  std::vector<std::string> images;
+  DIR* dir = opendir(directory.c_str());
+  if (!dir)
+    return images;
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.' && HasImageExtension(entry->d_name))
+      images.push_back(directory + "/" + entry->d_name);
+  }
+  closedir(dir);
+  std::sort(images.begin(), images.end());
+  return images;
+}
+
+// Returns the argument, or the contents of the file for "@path"
+bool ReadArgument(const char* argument, std::string& value) {
+  if (argument[0] != '@') {
+    value = argument;
+    return true;
+  }
+  FILE* file = fopen(argument + 1, "rb");
+  if (!file)
+    return false;
+  value.clear();
+  char buffer[4096];
+  size_t size = 0;
+  while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    value.append(buffer, size);
+  fclose(file);
+  return true;
+}
+
+struct Options {
+  std::string images_dir;
+  std::string config_path;
+  std::string session_params;
+  std::string signature;
+  std::string output_path;
+  int iterations = 10;
+  int threads = 1;
+  int warmup = 1;
+};
+
+// Per-thread benchmark state
+struct Worker {
+  std::unique_ptr<ocrstudio::OCRStudioSDKSession> session;
+  StageTimings load;
+  StageTimings process;
+  StageTimings result;
+  StageTimings total;
+};
+
+// Loads, processes and reads the result for one image
+void RunImage(Worker& worker, const std::string& image_path, bool measured) {
+  const Clock::time_point start = Clock::now();
+  std::unique_ptr<ocrstudio::OCRStudioSDKImage> image;
+  try {
+    image.reset(ocrstudio::OCRStudioSDKImage::CreateFromFile(image_path.c_str()));
+  } catch (...) {
+    if (measured)
+      ++worker.load.errors;
+    return;
+  }
+  const double load_ms = MillisecondsSince(start);
+
+  const Clock::time_point process_start = Clock::now();
+  try {
+    worker.session->Reset();
+    worker.session->ProcessImage(*image);
+  } catch (...) {
+    if (measured)
+      ++worker.process.errors;
+    return;
+  }
+  const double process_ms = MillisecondsSince(process_start);
+
+  // Result stage: walking all items, as a typical integration does
+  const Clock::time_point result_start = Clock::now();
+  try {
+    const ocrstudio::OCRStudioSDKResult& result = worker.session->CurrentResult();
+    size_t visited = 0;
+    for (int i = 0; i < result.TargetsCount(); ++i) {
+      const ocrstudio::OCRStudioSDKTarget& target = result.TargetByIndex(i);
+      for (auto it = target.ItemsBegin("string"); it != target.ItemsEnd("string"); it.Step())
+        visited += strlen(it.Item().Value());
+    }
+    (void)visited;
+  } catch (...) {
+    if (measured)
+      ++worker.result.errors;
+    return;
+  }
+  const double result_ms = MillisecondsSince(result_start);
+
+  if (measured) {
+    worker.load.samples.push_back(load_ms);
+    worker.process.samples.push_back(process_ms);
+    worker.result.samples.push_back(result_ms);
+    worker.total.samples.push_back(MillisecondsSince(start));
+  }
+}
+
+void PrintUsage(const char* program) {
+  printf("Version %s. Usage: %s <images_dir> <config_path> <session_params> "
+         "[--signature <signature>] [--iterations <N>] [--threads <M>] "
+         "[--warmup <K>] [--output <report.json>]\n"
+         "  session_params - session parameters JSON, or @<path> to a file with it\n"
+         "  signature      - personalized signature, or @<path> to a file with it "
+         "(default: OCRSTUDIOSDK_SIGNATURE environment variable)\n",
+         ocrstudio::OCRStudioSDKInstance::LibraryVersion(), program);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  // 1st argument - directory with the images to be processed
+  // 2nd argument - path to the configuration file
+  // 3rd argument - session parameters JSON (or @file)
+  // further optional arguments - see PrintUsage()
+  if (argc < 4) {
+    PrintUsage(argv[0]);
+    return -1;
+  }
+
+  Options options;
+  options.images_dir = argv[1];
+  options.config_path = argv[2];
+  if (!ReadArgument(argv[3], options.session_params)) {
+    printf("Cannot read session parameters: %s\n", argv[3]);
+    return -1;
+  }
+  if (const char* signature = getenv("OCRSTUDIOSDK_SIGNATURE"))
+    options.signature = signature;
+  for (int i = 4; i < argc; i += 2) {
+    if (i + 1 >= argc) {
+      PrintUsage(argv[0]);
+      return -1;
+    }
+    const std::string key = argv[i];
+    const char* value = argv[i + 1];
+    if (key == "--signature") {
+      if (!ReadArgument(value, options.signature)) {
+        printf("Cannot read signature: %s\n", value);
+        return -1;
+      }
+    } else if (key == "--iterations") {
+      options.iterations = atoi(value);
+    } else if (key == "--threads") {
+      options.threads = atoi(value);
+    } else if (key == "--warmup") {
+      options.warmup = atoi(value);
+    } else if (key == "--output") {
+      options.output_path = value;
+    } else {
+      PrintUsage(argv[0]);
+      return -1;
+    }
+  }
+  if (options.iterations < 1 || options.threads < 1 || options.warmup < 0) {
+    printf("Iterations and threads must be positive, warmup non-negative\n");
+    return -1;
+  }
+
+  const std::vector<std::string> images = ListImages(options.images_dir);
+  if (images.empty()) {
+    printf("No images found in %s\n", options.images_dir.c_str());
+    return -1;
+  }
+
+  try {
+    // Configuration and session creation are measured once
+    StageTimings instance_stage;
+    Clock::time_point start = Clock::now();
+    std::unique_ptr<ocrstudio::OCRStudioSDKInstance> engine_instance(
+        ocrstudio::OCRStudioSDKInstance::CreateFromPath(options.config_path.c_str()));
+    instance_stage.samples.push_back(MillisecondsSince(start));
+
+    StageTimings session_stage;
+    std::vector<Worker> workers(static_cast<size_t>(options.threads));
+    for (size_t i = 0; i < workers.size(); ++i) {
+      start = Clock::now();
+      workers[i].session.reset(engine_instance->CreateSession(
+          options.signature.c_str(), options.session_params.c_str()));
+      session_stage.samples.push_back(MillisecondsSince(start));
+    }
+
+    // Warmup: every thread processes all images, nothing is recorded
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < workers.size(); ++i) {
+      threads.emplace_back([&options, &images, &workers, i]() {
+        for (int pass = 0; pass < options.warmup; ++pass) {
+          for (size_t k = 0; k < images.size(); ++k)
+            RunImage(workers[i], images[k], false);
+        }
+      });
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+      threads[i].join();
+    threads.clear();
+
+    // Measured run: iterations over all images, shared between the threads
+    const long long jobs_count = static_cast<long long>(options.iterations) * images.size();
+    std::atomic<long long> next_job(0);
+    const Clock::time_point run_start = Clock::now();
+    for (size_t i = 0; i < workers.size(); ++i) {
+      threads.emplace_back([&images, &workers, &next_job, jobs_count, i]() {
+        for (long long job = next_job.fetch_add(1); job < jobs_count;
+             job = next_job.fetch_add(1)) {
+          RunImage(workers[i], images[static_cast<size_t>(job % images.size())], true);
+        }
+      });
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+      threads[i].join();
+    const double run_ms = MillisecondsSince(run_start);
+
+    StageTimings load, process, result, total;
+    for (size_t i = 0; i < workers.size(); ++i) {
+      load.Merge(workers[i].load);
+      process.Merge(workers[i].process);
+      result.Merge(workers[i].result);
+      total.Merge(workers[i].total);
+    }
+
+    std::string json = "{\"library_version\": ";
+    ocrstudio::detail::AppendJSONString(
+        json, ocrstudio::OCRStudioSDKInstance::LibraryVersion());
+    json += ", \"config\": ";
+    ocrstudio::detail::AppendJSONString(json, options.config_path.c_str());
+    json += ", \"images\": ";
+    ocrstudio::detail::AppendJSONNumber(json, static_cast<long long>(images.size()));
+    json += ", \"iterations\": ";
+    ocrstudio::detail::AppendJSONNumber(json, static_cast<long long>(options.iterations));
+    json += ", \"threads\": ";
+    ocrstudio::detail::AppendJSONNumber(json, static_cast<long long>(options.threads));
+    json += ", \"warmup\": ";
+    ocrstudio::detail::AppendJSONNumber(json, static_cast<long long>(options.warmup));
+    json += ", \"processed\": ";
+    ocrstudio::detail::AppendJSONNumber(json, static_cast<long long>(total.samples.size()));
+    json += ", \"failed\": ";
+    ocrstudio::detail::AppendJSONNumber(json, load.errors + process.errors + result.errors);
+    json += ", \"wall_time_ms\": ";
+    ocrstudio::detail::AppendJSONNumber(json, run_ms);
+    json += ", \"throughput_images_per_s\": ";
+    ocrstudio::detail::AppendJSONNumber(
+        json, run_ms > 0.0 ? total.samples.size() * 1000.0 / run_ms : 0.0);
+    json += ", \"peak_rss_bytes\": ";
+    ocrstudio::detail::AppendJSONNumber(json, PeakRSSBytes());
+    json += ", \"latency\": {";
+    AppendStage(json, "total", total);
+    json += "}, \"stages\": {";
+    AppendStage(json, "instance_creation", instance_stage);
+    json += ", ";
+    AppendStage(json, "session_creation", session_stage);
+    json += ", ";
+    AppendStage(json, "image_load", load);
+    json += ", ";
+    AppendStage(json, "process_image", process);
+    json += ", ";
+    AppendStage(json, "result_access", result);
+    json += "}}\n";
+
+    if (options.output_path.empty()) {
+      fputs(json.c_str(), stdout);
+    } else {
+      FILE* file = fopen(options.output_path.c_str(), "wb");
+      if (!file || fwrite(json.data(), 1, json.size(), file) != json.size()) {
+        printf("Cannot write report: %s\n", options.output_path.c_str());
+        if (file)
+          fclose(file);
+        return -1;
+      }
+      fclose(file);
+    }
+  } catch (const ocrstudio::OCRStudioSDKException& e) {
+    printf("Exception thrown: %s\n", e.Message());
+    return -1;
+  } catch (const std::exception& e) {
+    printf("Exception thrown: %s\n", e.what());
+    return -1;
+  }
+
+  return 0;
+}